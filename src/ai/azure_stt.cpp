@@ -4,9 +4,11 @@
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <WiFi.h>
-#include <WiFiClientSecure.h>
 
+#include "ai/azure_token.h"
+#include "audio/payload_arena.h"
 #include "config/mc_config_store.h"
+#include "utils/https_pool.h"
 #include "utils/logging.h"
 namespace azure_stt {
 static const char* kTag = "STT";
@@ -29,9 +31,12 @@ static String normalizeSpeechHost_(String host) {
 // PCM16 mono -> WAV bytes (in memory)
 //
 // NOTE:
+// - Recorder PCM in the payload arena has room for the header in front of
+//   it; the header is written there and the upload needs no copy.
 struct WavBuf {
   uint8_t* data_ = nullptr;
   size_t len_ = 0;
+  bool inPlace_ = false;  // data_ points into the recorder's buffer
 };
 static void putLE16_(uint8_t* p, uint16_t v) {
   p[0] = (uint8_t)(v & 0xFF);
@@ -44,25 +49,32 @@ static void putLE32_(uint8_t* p, uint32_t v) {
   p[3] = (uint8_t)((v >> 24) & 0xFF);
 }
 static void freeWav_(WavBuf& b) {
-  if (b.data_) {
-    free(b.data_);
-    b.data_ = nullptr;
-  }
+  if (b.data_ && !b.inPlace_) payload_arena::release(b.data_);
+  b.data_ = nullptr;
   b.len_ = 0;
+  b.inPlace_ = false;
 }
 static bool makeWav_(const int16_t* pcm, size_t samples, uint32_t sampleRate, WavBuf& out) {
   // Build a minimal WAV buffer in memory for STT upload.
+  static const size_t kHeader = 44;
   freeWav_(out);
   if (!pcm || samples == 0) return false;
   const uint32_t dataBytes = (uint32_t)(samples * sizeof(int16_t));
-  out.len_ = 44 + (size_t)dataBytes;
-  out.data_ = (uint8_t*)malloc(out.len_);
+  out.len_ = kHeader + (size_t)dataBytes;
+  if (payload_arena::headroom(pcm) >= kHeader) {
+    // The bytes in front of pcm are reserved by the recorder for this.
+    out.data_ = (uint8_t*)const_cast<int16_t*>(pcm) - kHeader;
+    out.inPlace_ = true;
+  } else {
+    out.data_ = payload_arena::acquire(payload_arena::Slot::Net, out.len_);
+    if (!out.data_) out.data_ = (uint8_t*)malloc(out.len_);
+  }
   if (!out.data_) {
     out.len_ = 0;
     return false;
   }
-  memset(out.data_, 0, out.len_);
   uint8_t* h = out.data_;
+  memset(h, 0, kHeader);
   // RIFF header
   memcpy(h + 0, "RIFF", 4);
   putLE32_(h + 4, 36 + dataBytes);
@@ -80,7 +92,7 @@ static bool makeWav_(const int16_t* pcm, size_t samples, uint32_t sampleRate, Wa
   memcpy(h + 36, "data", 4);
   putLE32_(h + 40, dataBytes);
   // PCM payload (little-endian)
-  memcpy(h + 44, (const uint8_t*)pcm, dataBytes);
+  if (!out.inPlace_) memcpy(h + kHeader, (const uint8_t*)pcm, dataBytes);
   return true;
 }
 SttResult transcribePcm16Mono(
@@ -130,17 +142,26 @@ SttResult transcribePcm16Mono(
     MC_LOGE("STT", "makeWav failed samples=%u", (unsigned)samples);
     return r;
   }
-  WiFiClientSecure client;
-  client.setInsecure();
-  HTTPClient https;
+  https_pool::Lease lease;
+  if (!lease.acquire(url.c_str())) {
+    freeWav_(wav);
+    r.ok_ = false;
+    r.err_ = "STT接続に失敗";
+    r.status_ = -20;
+    MC_EVT("STT", "fail stage=begin");
+    MC_LOGE("STT", "no client");
+    return r;
+  }
+  HTTPClient& https = lease.http();
   https.setTimeout((int)timeoutMs);
 #if defined(HTTPCLIENT_DEFAULT_TCP_TIMEOUT)
   https.setConnectTimeout((int)timeoutMs);
 #endif
-  https.setReuse(false);
-  MC_EVT_D("STT", "start custom=%d bytes=%u timeout=%lums",
-           useCustomHost ? 1 : 0, (unsigned)wav.len_, (unsigned long)timeoutMs);
-  if (!https.begin(client, url)) {
+  https.setReuse(true);
+  MC_EVT_D("STT", "start custom=%d bytes=%u timeout=%lums reuse=%d",
+           useCustomHost ? 1 : 0, (unsigned)wav.len_, (unsigned long)timeoutMs,
+           lease.reused() ? 1 : 0);
+  if (!https.begin(lease.client(), url)) {
     freeWav_(wav);
     r.ok_ = false;
     r.err_ = "STT接続に失敗";
@@ -149,11 +170,19 @@ SttResult transcribePcm16Mono(
     MC_LOGE("STT", "https.begin failed");
     return r;
   }
-  https.addHeader("Ocp-Apim-Subscription-Key", key);
+  // Shared background-refreshed token when there is one (no STS wait here).
+  String token;
+  const bool hasToken = azure_token::get(&token);
+  if (hasToken) {
+    https.addHeader("Authorization", "Bearer " + token);
+  } else {
+    https.addHeader("Ocp-Apim-Subscription-Key", key);
+  }
   String ct = "audio/wav; codecs=audio/pcm; samplerate=" + String(sampleRate);
   https.addHeader("Content-Type", ct);
   const uint32_t t0 = millis();
-  const int httpCode = https.POST(wav.data_, wav.len_);
+  int httpCode = https.POST(wav.data_, wav.len_);
+  if (lease.retryFresh(httpCode, false)) httpCode = https.POST(wav.data_, wav.len_);
   const uint32_t took = millis() - t0;
   freeWav_(wav);
   r.status_ = httpCode;
@@ -171,6 +200,7 @@ SttResult transcribePcm16Mono(
   const uint32_t bodyLen = (uint32_t)body.length();
   https.end();
   if (httpCode != 200) {
+    if (hasToken && httpCode == 401) azure_token::invalidate();
     r.ok_ = false;
     r.err_ = "STT失敗";
     MC_EVT("STT", "fail stage=http status=%d took=%lums body_len=%lu",
@@ -0,0 +1,352 @@
+// Module implementation.
+#include "ai/azure_token.h"
+
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <WiFi.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "config/config.h"
+#include "utils/buffered_reader.h"
+#include "utils/https_pool.h"
+#include "utils/logging.h"
+
+namespace azure_token {
+namespace {
+static const char* kPath = "/az_token.json";
+static const uint32_t kTtlMs = MC_AZ_TOKEN_TTL_MS;
+static const uint32_t kRefreshMs = MC_AZ_TOKEN_REFRESH_MS;
+// No get() for this long -> stop renewing until the next one.
+static const uint32_t kIdleMs = MC_AZ_TOKEN_IDLE_MS;
+// A persisted token needs at least this much life left to be adopted.
+static const uint32_t kAdoptMinSec = 60;
+static const uint32_t kFetchTimeoutMs = 6000;
+static const uint32_t kBodyTimeoutMs = 1500;
+static const size_t kMaxTok = 2048;
+// Refresh task wake-up period (WiFi / due checks).
+static const uint32_t kPollMs = 1000;
+
+static SemaphoreHandle_t g_mutex = nullptr;
+static SemaphoreHandle_t g_fetchMutex = nullptr;  // one STS request at a time
+static TaskHandle_t g_task = nullptr;
+static BufferedReader g_rx;                        // under g_fetchMutex
+static String   g_region;
+static String   g_key;
+static String   g_customHost;
+static uint32_t g_id = 0;          // settings hash (cache owner)
+static String   g_token;
+static uint32_t g_expireMs = 0;    // g_token unusable from here
+static uint32_t g_refreshMs = 0;   // background renewal from here
+static uint32_t g_failUntilMs = 0;
+static uint8_t  g_failCount = 0;
+static uint32_t g_useMs = 0;       // last begin() / get()
+// Read from the file before the clock was set; adopted once it is.
+static String   g_pendTok;
+static uint32_t g_pendExp = 0;
+
+struct Lock_ {
+  explicit Lock_(SemaphoreHandle_t m) : m_(m) {
+    if (m_) xSemaphoreTake(m_, portMAX_DELAY);
+  }
+  ~Lock_() { if (m_) xSemaphoreGive(m_); }
+  SemaphoreHandle_t m_;
+};
+
+static uint32_t epochNow_() {
+  const time_t t = time(nullptr);
+  return (t > 1600000000) ? (uint32_t)t : 0;
+}
+static bool reached_(uint32_t now, uint32_t at) {
+  return (int32_t)(now - at) >= 0;
+}
+static uint32_t hashSettings_(const String& region, const String& key,
+                              const String& host) {
+  // FNV-1a 32; only tells whose token the file holds.
+  uint32_t h = 2166136261u;
+  auto mix = [&h](const String& s) {
+    for (size_t i = 0; i < s.length(); ++i) {
+      h ^= (uint8_t)s[i];
+      h *= 16777619u;
+    }
+    h ^= '\n';
+    h *= 16777619u;
+  };
+  mix(region);
+  mix(key);
+  mix(host);
+  return h;
+}
+static String snippet_(const String& s) {
+  // Avoid logging full tokens. Show a small redacted snippet only.
+  const size_t n = s.length();
+  if (n == 0) return "(empty)";
+  if (n <= 12) return s;
+  return s.substring(0, 8) + "..." + s.substring(n - 8);
+}
+// Caller holds g_mutex.
+static void set_(const String& tok, uint32_t lifeMs) {
+  const uint32_t now = millis();
+  g_token = tok;
+  g_expireMs = now + lifeMs;
+  const uint32_t lead = kTtlMs - kRefreshMs;  // renew this long before expiry
+  g_refreshMs = now + (lifeMs > lead ? lifeMs - lead : 0);
+}
+static void clear_() {
+  g_token = "";
+  g_expireMs = 0;
+  g_refreshMs = 0;
+}
+static void save_(const String& tok, uint32_t id) {
+  const uint32_t epoch = epochNow_();
+  if (!epoch || !LittleFS.begin(true)) return;
+  JsonDocument doc;
+  char ids[9];
+  snprintf(ids, sizeof(ids), "%08lx", (unsigned long)id);
+  doc["id"] = ids;
+  doc["tok"] = tok;
+  doc["exp"] = epoch + kTtlMs / 1000;
+  File f = LittleFS.open(kPath, "w");
+  if (!f) {
+    MC_LOGD("AZ_TOKEN", "cache open failed");
+    return;
+  }
+  serializeJson(doc, f);
+  f.close();
+}
+static void remove_() {
+  if (LittleFS.begin(true) && LittleFS.exists(kPath)) LittleFS.remove(kPath);
+}
+// Caller holds g_mutex.
+static void load_() {
+  g_pendTok = "";
+  g_pendExp = 0;
+  if (!LittleFS.begin(true) || !LittleFS.exists(kPath)) return;
+  File f = LittleFS.open(kPath, "r");
+  if (!f) return;
+  JsonDocument doc;
+  const DeserializationError e = deserializeJson(doc, f);
+  f.close();
+  if (e) return;
+  const uint32_t id = (uint32_t)strtoul(doc["id"] | "0", nullptr, 16);
+  const char* tok = doc["tok"] | "";
+  if (id != g_id || !tok[0]) return;
+  g_pendTok = tok;
+  g_pendExp = doc["exp"] | 0u;
+}
+// Caller holds g_mutex. Adopts the persisted token once the clock allows.
+static void adoptPending_() {
+  if (!g_pendTok.length()) return;
+  const uint32_t epoch = epochNow_();
+  if (!epoch) return;
+  if (!g_token.length() && g_pendExp > epoch + kAdoptMinSec) {
+    const uint32_t leftSec = g_pendExp - epoch;
+    set_(g_pendTok, leftSec * 1000UL);
+    MC_LOGI("AZ_TOKEN", "cached token adopted (left=%lus)", (unsigned long)leftSec);
+  }
+  g_pendTok = "";
+  g_pendExp = 0;
+}
+
+static bool tryUrl_(const String& url, const char* label, const String& key,
+                    String* outTok) {
+  MC_LOGI("AZ_TOKEN", "try %s url=%s", label, url.c_str());
+  https_pool::Lease lease;
+  if (!lease.acquire(url.c_str())) return false;
+  HTTPClient& h = lease.http();
+  h.setReuse(true);
+  h.useHTTP10(false);
+  h.setTimeout(kFetchTimeoutMs);
+  if (!h.begin(lease.client(), url)) {
+    MC_LOGI("AZ_TOKEN", "begin failed (%s)", label);
+    h.end();
+    return false;
+  }
+  h.addHeader("Content-type", "application/x-www-form-urlencoded");
+  h.addHeader("Content-length", "0");
+  h.addHeader("Ocp-Apim-Subscription-Key", key);
+  int code = h.POST((uint8_t*)nullptr, 0);
+  if (lease.retryFresh(code, true)) code = h.POST((uint8_t*)nullptr, 0);
+  MC_LOGI("AZ_TOKEN", "POST done code=%d (%s)", code, label);
+  if (code != 200) {
+    String body = h.getString();
+    String err = h.errorToString(code);
+    MC_LOGI("AZ_TOKEN", "HTTP %d (%s) err=%s body_len=%u",
+            code, label, err.c_str(), (unsigned)body.length());
+    h.end();
+    return false;
+  }
+  String tok;
+  const int total = h.getSize();  // -1 if unknown (chunked)
+  WiFiClient* s = h.getStreamPtr();
+  const uint32_t t0 = millis();
+  g_rx.attach(s);
+  char buf[256];
+  while (s && tok.length() < kMaxTok) {
+    const uint32_t el = millis() - t0;
+    if (el >= kBodyTimeoutMs) break;
+    size_t want = kMaxTok - tok.length();
+    if (total > 0 && (size_t)total - tok.length() < want) want = (size_t)total - tok.length();
+    if (want == 0) break;
+    const int r = g_rx.readSome((uint8_t*)buf, (want < sizeof(buf)) ? want : sizeof(buf),
+                                kBodyTimeoutMs - el);
+    if (r <= 0) break;
+    tok.concat(buf, (unsigned)r);
+  }
+  g_rx.attach(nullptr);
+  const size_t rawLen = tok.length();
+  tok.trim();
+  MC_LOGI("AZ_TOKEN", "HTTP 200 body_len=%u trimmed=%u size=%d (%s)",
+          (unsigned)rawLen, (unsigned)tok.length(), total, label);
+  MC_LOGD("AZ_TOKEN", "body_snip=%s", snippet_(tok).c_str());
+  h.end();
+  if (!tok.length()) {
+    MC_LOGI("AZ_TOKEN", "HTTP 200 but empty body (%s)", label);
+    return false;
+  }
+  *outTok = tok;
+  return true;
+}
+// Regional STS first, then the custom host (legacy / some tenants).
+// Updates the shared token (and the file) on success, the backoff on failure.
+static bool fetch_() {
+  Lock_ fl(g_fetchMutex);
+  String region, key, host;
+  uint32_t id;
+  {
+    Lock_ l(g_mutex);
+    region = g_region;
+    key = g_key;
+    host = g_customHost;
+    id = g_id;
+  }
+  if (!key.length()) {
+    MC_LOGI("AZ_TOKEN", "skip: key empty");
+    return false;
+  }
+  String tok;
+  bool ok = false;
+  if (region.length()) {
+    ok = tryUrl_(String("https://") + region + ".api.cognitive.microsoft.com/sts/v1.0/issueToken",
+                 "region", key, &tok);
+  } else {
+    MC_LOGI("AZ_TOKEN", "skip: region empty");
+  }
+  if (!ok && host.length()) {
+    ok = tryUrl_(String("https://") + host + "/sts/v1.0/issueToken", "custom", key, &tok);
+  }
+  if (ok) {
+    {
+      Lock_ l(g_mutex);
+      if (id != g_id) return false;  // settings changed meanwhile
+      set_(tok, kTtlMs);
+      g_failCount = 0;
+      g_failUntilMs = 0;
+      g_pendTok = "";
+    }
+    save_(tok, id);
+    MC_LOGI("AZ_TOKEN", "ok (valid %lus, renew in %lus)",
+            (unsigned long)(kTtlMs / 1000), (unsigned long)(kRefreshMs / 1000));
+    return true;
+  }
+  Lock_ l(g_mutex);
+  if (id != g_id) return false;
+  const uint32_t now = millis();
+  g_failCount = (uint8_t)min<int>(g_failCount + 1, 10);
+  const uint32_t backoff = 1000u * (1u << min<int>(g_failCount, 6));  // up to ~64s
+  g_failUntilMs = now + backoff;
+  MC_LOGI_RL("AZ.token.fail", 5000, "AZ_TOKEN",
+             "fail (cooldown=%us)", (unsigned)(backoff / 1000));
+  return false;
+}
+static void refreshTask_(void*) {
+  bool idle = false;
+  for (;;) {
+    // Idle: sleep until get() wants a token (none / in the renewal window).
+    ulTaskNotifyTake(pdTRUE, idle ? portMAX_DELAY : pdMS_TO_TICKS(kPollMs));
+    if (WiFi.status() != WL_CONNECTED) continue;
+    bool due;
+    {
+      Lock_ l(g_mutex);
+      adoptPending_();
+      const uint32_t now = millis();
+      const bool wasIdle = idle;
+      idle = reached_(now, g_useMs + kIdleMs);
+      if (idle && !wasIdle) {
+        MC_LOGD("AZ_TOKEN", "unused for %lus: renewal paused",
+                (unsigned long)(kIdleMs / 1000));
+      }
+      due = !idle && g_key.length() &&
+            (!g_token.length() || reached_(now, g_refreshMs)) &&
+            (!g_failUntilMs || reached_(now, g_failUntilMs));
+    }
+    if (due) fetch_();
+  }
+}
+} // namespace
+
+void begin(const String& region, const String& key, const String& customHost) {
+  if (!g_mutex) g_mutex = xSemaphoreCreateMutex();
+  if (!g_fetchMutex) g_fetchMutex = xSemaphoreCreateMutex();
+  {
+    Lock_ l(g_mutex);
+    const uint32_t id = hashSettings_(region, key, customHost);
+    if (id != g_id || !g_task) {
+      g_region = region;
+      g_key = key;
+      g_customHost = customHost;
+      g_id = id;
+      clear_();
+      g_failCount = 0;
+      g_failUntilMs = 0;
+      load_();
+      adoptPending_();
+    }
+    g_useMs = millis();  // fetch once up front; kept warm while used
+  }
+  if (g_task) return;
+  // 8 KB like the azure_tts task the fetch used to run on (TLS handshake).
+  xTaskCreatePinnedToCore(refreshTask_, "AzToken", 8192, nullptr, 1, &g_task, 0);
+}
+
+bool get(String* out) {
+  bool ok = false;
+  bool renew = false;
+  {
+    Lock_ l(g_mutex);
+    adoptPending_();
+    const uint32_t now = millis();
+    g_useMs = now;
+    if (g_token.length() && !reached_(now, g_expireMs)) {
+      if (out) *out = g_token;
+      ok = true;
+      renew = reached_(now, g_refreshMs);
+    }
+  }
+  // Also in the renewal window: the task may be idle and not polling.
+  if ((!ok || renew) && g_task) xTaskNotifyGive(g_task);
+  return ok;
+}
+
+bool refreshNow() {
+  if (!g_mutex) return false;
+  if (WiFi.status() != WL_CONNECTED) {
+    MC_LOGI_RL("AZ.token.wifi", 5000, "AZ_TOKEN", "fetch skipped: wifi not connected");
+    return false;
+  }
+  return fetch_();
+}
+
+void invalidate() {
+  {
+    Lock_ l(g_mutex);
+    clear_();
+    g_pendTok = "";
+  }
+  remove_();
+  if (g_task) xTaskNotifyGive(g_task);
+}
+} // namespace azure_token
@@ -0,0 +1,31 @@
+// Module implementation.
+// Azure Speech access token (STS issueToken) shared by TTS and STT.
+//
+// A background task fetches the token and renews it before it expires, so a
+// speak / listen request only reads the current one and never waits on the
+// STS round trip (and its TLS handshake). Renewal stops once nothing has
+// asked for the token for MC_AZ_TOKEN_IDLE_MS; the next get() restarts it. The token is also kept on LittleFS
+// (/az_token.json) with its wall-clock expiry, so a soft reboot can reuse it
+// while it is still valid.
+//
+// NOTE:
+// - Thread-safe; state is behind one mutex. get() never blocks on network.
+// - No token yet (first boot, STS down) -> get() returns false and callers
+//   send the subscription key header instead, as before.
+// - The persisted token is only trusted when the clock is set (NTP / kept
+//   over a soft reset) and it was issued for the same region / key / host.
+#pragma once
+#include <Arduino.h>
+
+namespace azure_token {
+// Set region / key / custom host (empty = none), load the cache and start
+// the refresh task. Calling again with other settings drops the token.
+void begin(const String& region, const String& key, const String& customHost);
+// Current token (non-blocking). Wakes the refresh task when there is none
+// or it is due for renewal.
+bool get(String* out);
+// Fetch now on the calling task (credential check). Updates the shared token.
+bool refreshNow();
+// Drop the token (e.g. the service rejected it); the task fetches a new one.
+void invalidate();
+} // namespace azure_token
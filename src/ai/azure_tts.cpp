@@ -14,9 +14,23 @@
 #endif
 #include <WiFi.h>
 
+#include "ai/azure_token.h"
+#include "ai/tts_cache.h"
 #include "audio/i2s_manager.h"
+#include "audio/payload_arena.h"
 #include "config/mc_config_store.h"
 #include "utils/logging.h"
+#include "utils/mc_text_utils.h"
+// Requested audio format (also part of the cache key).
+static const char* kOutputFormat = "riff-16khz-16bit-mono-pcm";
+// Speaker channel used for streamed blocks (playRaw queues two per channel).
+static const uint8_t kStreamChannel = 0;
+// Bytes collected from the body before the WAV header has to be complete.
+static const size_t kStreamHeadMax = 512;
+// Body bytes after the WAV data read off a keep-alive response; more = close.
+static const size_t kStreamDrainMax = 4096;
+// streamPut_ re-checks the abort flag this often while waiting for a block.
+static const uint32_t kStreamWaitMs = 100;
 // TTS debug switch (optional): define -DTTS_DEBUG_ENABLED=1 to restore very chatty logs.
 #ifndef TTS_DEBUG_ENABLED
 #define TTS_DEBUG_ENABLED 0
@@ -27,88 +41,173 @@ static String trimCopy_(const String& s) {
   t.trim();
   return t;
 }
-static bool readLineCRLF_(WiFiClient* s, String* out, uint32_t idleTimeoutMs) {
-  // Line reader used for both chunked decoding and HTTP header parsing.
-  out->remove(0);
-  uint32_t t0 = millis();
-  while (true) {
-    while (s->available()) {
-      char c = (char)s->read();
-      if (c == '\r') continue;
-      if (c == '\n') return true;
-      out->concat(c);
-      if (out->length() > 64) return false; // too long
+// Chunk-size lines are short ("1000", "1a;ext=..."); longer means garbage.
+static const size_t kChunkLineMax = 64;
+static bool parseChunkSize_(char* line, unsigned long* out) {
+  char* p = line;
+  while (*p == ' ' || *p == '\t') p++;
+  // chunk-size (hex) may have extensions: "1a;foo=bar"
+  char* semi = strchr(p, ';');
+  if (semi) *semi = 0;
+  char* endp = nullptr;
+  *out = strtoul(p, &endp, 16);
+  return endp && endp != p;
+}
+static bool isBlank_(const char* s) {
+  while (*s == ' ' || *s == '\t') s++;
+  return *s == 0;
+}
+// Largest WAV body accepted (16 kHz PCM16: ~16 s).
+static const size_t kBodyCapMax = 512 * 1024;
+// Body buffer: the payload arena's Net slot when there is one (fixed size,
+// never reallocated), else heap memory doubling from 8 KB as before.
+struct BodyBuf_ {
+  uint8_t* p_ = nullptr;
+  size_t cap_ = 0;
+  size_t used_ = 0;
+  bool arena_ = false;
+  bool init() {
+    p_ = payload_arena::acquire(payload_arena::Slot::Net, 0, &cap_);
+    arena_ = (p_ != nullptr);
+    if (arena_) {
+      if (cap_ > kBodyCapMax) cap_ = kBodyCapMax;
+      return true;
     }
-    if (!s->connected()) return false;
-    if (millis() - t0 > idleTimeoutMs) return false;
-    delay(1);
+    cap_ = 8192;
+    p_ = (uint8_t*)malloc(cap_);
+    return p_ != nullptr;
   }
-}
-static bool readExact_(WiFiClient* s, uint8_t* dst, size_t n, uint32_t idleTimeoutMs) {
-  size_t got = 0;
-  uint32_t t0 = millis();
-  while (got < n) {
-    int a = s->available();
-    if (a <= 0) {
-      if (!s->connected()) return false;
-      if (millis() - t0 > idleTimeoutMs) return false;
-      delay(1);
-      continue;
+  bool reserve(size_t need) {
+    if (need > kBodyCapMax) return false;
+    while (need > cap_) {
+      if (arena_) return false;
+      size_t ncap = cap_ * 2;
+      if (ncap > kBodyCapMax) ncap = kBodyCapMax;
+      uint8_t* nb = (uint8_t*)realloc(p_, ncap);
+      if (!nb) return false;
+      p_ = nb;
+      cap_ = ncap;
     }
-    t0 = millis();
-    int r = s->readBytes(dst + got, (size_t)min<int>(a, (int)(n - got)));
-    if (r <= 0) return false;
-    got += (size_t)r;
+    return true;
   }
-  return true;
-}
-static bool readChunkedBody_(WiFiClient* s, uint8_t** outBuf, size_t* outLen, uint32_t idleTimeoutMs) {
+  void drop() {
+    payload_arena::release(p_);
+    p_ = nullptr;
+    cap_ = used_ = 0;
+  }
+  // Hand the bytes to the caller (release with payload_arena::release()).
+  bool take(uint8_t** outBuf, size_t* outLen) {
+    if (!used_) {
+      drop();
+      return false;
+    }
+    *outBuf = p_;
+    *outLen = used_;
+    p_ = nullptr;
+    return true;
+  }
+};
+static bool readChunkedBody_(BufferedReader& rx, uint8_t** outBuf, size_t* outLen, uint32_t idleTimeoutMs) {
   // Strict chunked reader used when the server properly frames payload.
   *outBuf = nullptr;
   *outLen = 0;
-  const size_t kCapMax = 512 * 1024;
-  size_t cap = 8192;
-  size_t used = 0;
-  uint8_t* buf = (uint8_t*)malloc(cap);
-  if (!buf) return false;
+  BodyBuf_ b;
+  if (!b.init()) return false;
   while (true) {
-    String line;
-    if (!readLineCRLF_(s, &line, idleTimeoutMs)) { free(buf); return false; }
-    line.trim();
-    if (!line.length()) continue; // skip empty lines
-    // chunk-size (hex) may have extensions: "1a;foo=bar"
-    int semi = line.indexOf(';');
-    if (semi >= 0) line = line.substring(0, semi);
-    char* endp = nullptr;
-    unsigned long chunk = strtoul(line.c_str(), &endp, 16);
-    if (!endp || endp == line.c_str()) { free(buf); return false; }
+    char line[kChunkLineMax + 1];
+    if (rx.readLine(line, sizeof(line), idleTimeoutMs) < 0) { b.drop(); return false; }
+    if (isBlank_(line)) continue; // skip empty lines
+    unsigned long chunk = 0;
+    if (!parseChunkSize_(line, &chunk)) { b.drop(); return false; }
     if (chunk == 0) {
       // consume trailing headers (optional) until empty line
       // (Azure usually ends soon; safe to just read one line if present)
       // We'll try to read one line; ignore failures.
-      String tail;
-      (void)readLineCRLF_(s, &tail, 50);
+      (void)rx.readLine(line, sizeof(line), 50);
       break;
     }
-    if (used + chunk > kCapMax) { free(buf); return false; }
-    while (used + chunk > cap) {
-      size_t ncap = cap * 2;
-      if (ncap > kCapMax) { free(buf); return false; }
-      uint8_t* nb = (uint8_t*)realloc(buf, ncap);
-      if (!nb) { free(buf); return false; }
-      buf = nb;
-      cap = ncap;
-    }
-    if (!readExact_(s, buf + used, (size_t)chunk, idleTimeoutMs)) { free(buf); return false; }
-    used += (size_t)chunk;
+    if (!b.reserve(b.used_ + chunk)) { b.drop(); return false; }
+    if (!rx.readExact(b.p_ + b.used_, (size_t)chunk, idleTimeoutMs)) { b.drop(); return false; }
+    b.used_ += (size_t)chunk;
     // chunk terminator CRLF
     char crlf[2];
-    if (!readExact_(s, (uint8_t*)crlf, 2, idleTimeoutMs)) { free(buf); return false; }
+    if (!rx.readExact((uint8_t*)crlf, 2, idleTimeoutMs)) { b.drop(); return false; }
     // tolerate if not CRLF
   }
-  *outBuf = buf;
-  *outLen = used;
-  return used > 0;
+  return b.take(outBuf, outLen);
+}
+// ---------- incremental body reader (streaming playback) ----------
+// De-chunks on the fly (or counts down Content-Length) so the caller can
+// consume the body as it arrives.
+struct TtsBodyReader_ {
+  BufferedReader* rx_ = nullptr;
+  bool chunked_ = false;
+  bool afterChunk_ = false;   // chunk payload done, its CRLF not read yet
+  bool eof_ = false;
+  size_t left_ = 0;           // bytes left in this chunk / in the body
+  uint32_t idleMs_ = 5000;
+  const std::atomic<bool>* abort_ = nullptr;
+  // Up to n bytes (>0), 0 at the end of the body, -1 on error / timeout / abort.
+  int read(uint8_t* dst, size_t n) {
+    if (eof_) return 0;
+    if (chunked_ && left_ == 0) {
+      if (afterChunk_) {
+        char crlf[2];
+        if (!rx_->readExact((uint8_t*)crlf, 2, idleMs_)) return -1;
+        afterChunk_ = false;
+      }
+      char line[kChunkLineMax + 1];
+      do {
+        if (rx_->readLine(line, sizeof(line), idleMs_) < 0) return -1;
+      } while (isBlank_(line));
+      unsigned long chunk = 0;
+      if (!parseChunkSize_(line, &chunk)) return -1;
+      if (chunk == 0) {
+        (void)rx_->readLine(line, sizeof(line), 50);
+        eof_ = true;
+        return 0;
+      }
+      left_ = (size_t)chunk;
+      afterChunk_ = true;
+    }
+    if (left_ == 0) {
+      eof_ = true;
+      return 0;
+    }
+    const int r = rx_->readSome(dst, (n < left_) ? n : left_, idleMs_, abort_);
+    if (r <= 0) return -1;  // closed before the announced length
+    left_ -= (size_t)r;
+    return r;
+  }
+  // Discards the rest of the body; false if it is longer than maxBytes or
+  // fails (the connection then must not be reused).
+  bool drain(size_t maxBytes) {
+    uint8_t tmp[256];
+    while (true) {
+      const int r = read(tmp, (maxBytes < sizeof(tmp)) ? maxBytes + 1 : sizeof(tmp));
+      if (r == 0) return true;
+      if (r < 0 || (size_t)r > maxBytes) return false;
+      maxBytes -= (size_t)r;
+    }
+  }
+};
+// Rest of the body after `head` into one body buffer (non-streamable
+// payload: not PCM16 mono, or chunk markers leaked into the body).
+static bool readRest_(TtsBodyReader_& br, const uint8_t* head, size_t headLen,
+                      uint8_t** outBuf, size_t* outLen) {
+  BodyBuf_ b;
+  if (!b.init()) return false;
+  if (!b.reserve(headLen)) { b.drop(); return false; }
+  memcpy(b.p_, head, headLen);
+  b.used_ = headLen;
+  while (true) {
+    if (b.used_ == b.cap_ && !b.reserve(b.cap_ + 1)) { b.drop(); return false; }
+    const int r = br.read(b.p_ + b.used_, b.cap_ - b.used_);
+    if (r < 0) { b.drop(); return false; }
+    if (r == 0) break;
+    b.used_ += (size_t)r;
+  }
+  return b.take(outBuf, outLen);
 }
 // ---------- chunked "salvage" (when chunk markers leak into body) ----------
 static bool isHexDigit_(char c) {
@@ -148,42 +247,27 @@ static bool looksLikeChunkedLeak_(const uint8_t* buf, size_t len) {
   }
   return false;
 }
-static bool dechunkMemory_(const uint8_t* in, size_t inLen, uint8_t** outBuf, size_t* outLen) {
+static bool dechunkInPlace_(uint8_t* buf, size_t inLen, size_t* outLen, bool write) {
   // Best-effort salvage for chunk markers accidentally embedded in the body.
-  if (!outBuf || !outLen) return false;
-  *outBuf = nullptr;
+  // Payload only moves towards the front (each chunk follows its size line),
+  // so the result is written over the input; write=false only validates.
+  if (!outLen) return false;
   *outLen = 0;
-  if (!in || inLen == 0) return false;
-  const size_t kCapMax = 512 * 1024;
-  size_t cap = 8192;
+  if (!buf || inLen == 0) return false;
   size_t used = 0;
-  uint8_t* buf = (uint8_t*)malloc(cap);
-  if (!buf) return false;
-  auto ensureCap = [&](size_t need) -> bool {
-    if (need > kCapMax) return false;
-    while (need > cap) {
-      size_t ncap = cap * 2;
-      if (ncap > kCapMax) return false;
-      uint8_t* nb = (uint8_t*)realloc(buf, ncap);
-      if (!nb) return false;
-      buf = nb;
-      cap = ncap;
-    }
-    return true;
-  };
   size_t pos = 0;
   while (pos < inLen) {
     // read line until '\n'
     size_t lineStart = pos;
     size_t lineEnd = pos;
-    while (lineEnd < inLen && in[lineEnd] != '\n') lineEnd++;
-    if (lineEnd >= inLen) { free(buf); return false; } // no LF -> malformed
+    while (lineEnd < inLen && buf[lineEnd] != '\n') lineEnd++;
+    if (lineEnd >= inLen) return false; // no LF -> malformed
     // line is [lineStart, lineEnd] excluding LF; may include CR
     // Copy to temp string (small)
     char line[64];
     size_t L = lineEnd - lineStart;
-    if (L >= sizeof(line)) { free(buf); return false; } // too long
-    memcpy(line, in + lineStart, L);
+    if (L >= sizeof(line)) return false; // too long
+    memcpy(line, buf + lineStart, L);
     line[L] = 0;
     pos = lineEnd + 1; // skip LF
     // trim CR/spaces
@@ -201,40 +285,26 @@ static bool dechunkMemory_(const uint8_t* in, size_t inLen, uint8_t** outBuf, si
     // parse hex
     char* endp = nullptr;
     unsigned long chunk = strtoul(p, &endp, 16);
-    if (!endp || endp == p) { free(buf); return false; }
+    if (!endp || endp == p) return false;
     if (chunk == 0) {
       // chunked end. There may be trailing headers and an empty line.
       // We can just stop here.
       break;
     }
-    if (pos + chunk > inLen) { free(buf); return false; }
-    if (!ensureCap(used + (size_t)chunk)) { free(buf); return false; }
-    memcpy(buf + used, in + pos, (size_t)chunk);
+    if (pos + chunk > inLen) return false;
+    if (write) memmove(buf + used, buf + pos, (size_t)chunk);
     used += (size_t)chunk;
     pos += (size_t)chunk;
     // skip CRLF after chunk payload if present
-    if (pos < inLen && in[pos] == '\r') pos++;
-    if (pos < inLen && in[pos] == '\n') pos++;
+    if (pos < inLen && buf[pos] == '\r') pos++;
+    if (pos < inLen && buf[pos] == '\n') pos++;
   }
-  if (used == 0) { free(buf); return false; }
-  *outBuf = buf;
+  if (used == 0) return false;
   *outLen = used;
   return true;
 }
 static void logHeadBytes_(const uint8_t* buf, size_t len);
 static uint32_t g_chunkedSalvageCount = 0;
-static String tokenSnippet_(const String& s) {
-  // Avoid logging full tokens. Show a small redacted snippet only.
-  const size_t n = s.length();
-  if (n == 0) return "(empty)";
-  if (n <= 12) return s;
-  String out;
-  out.reserve(8 + 3 + 8);
-  out += s.substring(0, 8);
-  out += "...";
-  out += s.substring(n - 8);
-  return out;
-}
 // === src/azure_tts.cpp : replace whole function ===
 static void salvageChunkedLeakIfNeeded_(uint8_t** pBuf, size_t* pLen) {
   // Fix up cases where chunk framing leaked into the response body.
@@ -247,19 +317,18 @@ static void salvageChunkedLeakIfNeeded_(uint8_t** pBuf, size_t* pLen) {
   MC_LOGW("TTS", "chunked markers leaked into body -> salvage");
   MC_LOGT("TTS", "chunked leak head dump follows");
   logHeadBytes_(buf, len);
-  uint8_t* fixed = nullptr;
+  // Validate first: a failed salvage must leave the body as it was.
   size_t fixedLen = 0;
-  if (dechunkMemory_(buf, len, &fixed, &fixedLen)) {
+  if (dechunkInPlace_(buf, len, &fixedLen, false) &&
+      dechunkInPlace_(buf, len, &fixedLen, true)) {
     g_chunkedSalvageCount++;
     MC_LOGD("TTS", "salvaged #%lu: %u -> %u bytes",
             (unsigned long)g_chunkedSalvageCount,
             (unsigned)len, (unsigned)fixedLen);
-    free(buf);
-    *pBuf = fixed;
     *pLen = fixedLen;
-    logHeadBytes_(fixed, fixedLen);
+    logHeadBytes_(buf, fixedLen);
   } else {
-    MC_LOGW("TTS", "salvage failed (dechunkMemory_)");
+    MC_LOGW("TTS", "salvage failed (dechunkInPlace_)");
   }
 }
 static String normalizeCustomHost_(const String& inRaw) {
@@ -333,6 +402,37 @@ static bool parseWavPcm_(const uint8_t* buf, size_t len, WavPcmInfo_* out) {
   out->bitsPerSample_ = bitsPerSample;
   return true;
 }
+// Header at the front of a streamed WAV: 1 = PCM16 mono, *dataOff is where
+// the samples start (*dataBytes 0 = size unknown); 0 = need more bytes;
+// -1 = not streamable.
+static int parseWavHeader_(const uint8_t* buf, size_t len, uint32_t* rate,
+                           size_t* dataOff, uint32_t* dataBytes) {
+  if (len < 12) return 0;
+  if (memcmp(buf, "RIFF", 4) != 0 || memcmp(buf + 8, "WAVE", 4) != 0) return -1;
+  bool fmtOk = false;
+  size_t pos = 12;
+  while (true) {
+    if (pos + 8 > len) return 0;
+    const uint8_t* ch = buf + pos;
+    const uint32_t csize = rd32le_(ch + 4);
+    if (memcmp(ch, "data", 4) == 0) {
+      if (!fmtOk) return -1;
+      *dataOff = pos + 8;
+      *dataBytes = (csize == 0xFFFFFFFFu) ? 0 : csize;
+      return 1;
+    }
+    if (pos + 8 + csize > len) return 0;
+    if (memcmp(ch, "fmt ", 4) == 0) {
+      if (csize < 16) return -1;
+      const uint8_t* f = ch + 8;
+      if (rd16le_(f + 0) != 1 || rd16le_(f + 2) != 1 || rd16le_(f + 14) != 16) return -1;
+      *rate = rd32le_(f + 4) ? rd32le_(f + 4) : 16000;
+      fmtOk = true;
+    }
+    pos += 8 + (size_t)csize;
+    if (pos & 1) pos++;
+  }
+}
 // === src/azure_tts.cpp : replace whole function ===
 static void logHeadBytes_(const uint8_t* buf, size_t len) {
   if (!buf || len == 0) return;
@@ -379,6 +479,9 @@ void AzureTts::begin(uint8_t volume) {
           (unsigned)defaultVoice_.length(),
           (unsigned)key_.length(),
           (unsigned)endpoint_.length());
+  payload_arena::begin();
+  tts_cache::begin();
+  azure_token::begin(region_, key_, customHost_);
   // audio
   defaultVolume_ = volume;
   M5.Speaker.setVolume(volume);
@@ -387,9 +490,6 @@ void AzureTts::begin(uint8_t volume) {
   https_.setReuse(true);
   // token state
   token_ = "";
-  tokenExpireMs_ = 0;
-  tokenFailUntilMs_ = 0;
-  tokenFailCount_ = 0;
   lastRequestMs_ = 0;
   dnsWarmed_ = false;
   sessionResetPending_ = false;
@@ -427,7 +527,7 @@ bool AzureTts::playbackEnabled() const { return playbackEnabled_; }
 bool AzureTts::testCredentials() {
   if (state_ != Idle) return false;
   if (!endpoint_.length() || !key_.length() || !defaultVoice_.length()) return false;
-  return ensureToken_();
+  return azure_token::refreshNow();
 }
 AzureTts::LastResult AzureTts::lastResult() const { return last_; }
 // ---- task ----
@@ -448,31 +548,58 @@ bool AzureTts::speakAsync(const String& text, uint32_t speakId, const char* voic
                (unsigned long)speakId, (unsigned)text.length());
     return false;
   }
-  if (WiFi.status() != WL_CONNECTED) {
+  String voiceName = voice ? String(voice) : defaultVoice_;
+  if (!voiceName.length()) voiceName = defaultVoice_;
+  // Long replies go out sentence by sentence (streaming only, see taskBody).
+  String segs[kMaxSegments];
+  size_t nSeg = 0;
+  if (cfg_.streaming && kMaxSegments > 1) {
+    nSeg = mcSplitSentences(text, segs, kMaxSegments, MC_TTS_SEGMENT_MIN_BYTES);
+  }
+  if (nSeg == 0) {
+    segs[0] = text;
+    nSeg = 1;
+  }
+  // Short phrases may already be on flash: those play without WiFi / Azure.
+  uint64_t keys[kMaxSegments] = {0};
+  bool cached = MC_TTS_CACHE && voiceName.length();
+  for (size_t i = 0; i < nSeg; ++i) {
+    if (MC_TTS_CACHE && voiceName.length() &&
+        segs[i].length() <= MC_TTS_CACHE_MAX_TEXT_BYTES) {
+      keys[i] = tts_cache::keyFor(buildSsml_(segs[i], voiceName), kOutputFormat);
+    }
+    cached = cached && keys[i] && tts_cache::contains(keys[i]);
+  }
+  if (!cached && WiFi.status() != WL_CONNECTED) {
     MC_LOGI_RL("TTS.rej.wifi", 3000, "TTS",
                "speakAsync rejected reason=wifi id=%lu",
                (unsigned long)speakId);
     return false;
   }
-  if (!endpoint_.length() || !key_.length()) {
+  if (!cached && (!endpoint_.length() || !key_.length())) {
     MC_LOGI_RL("TTS.rej.config", 5000, "TTS",
                "speakAsync rejected reason=config id=%lu",
                (unsigned long)speakId);
     return false;
   }
-  // Prepare request strings (same behavior as before).
-  reqText_  = text;
-  reqVoice_ = voice ? String(voice) : defaultVoice_;
-  if (!reqVoice_.length()) reqVoice_ = defaultVoice_;
-  if (!reqVoice_.length()) {
+  if (!voiceName.length()) {
     MC_LOGI_RL("TTS.rej.voice", 5000, "TTS",
                "speakAsync rejected reason=voice id=%lu",
                (unsigned long)speakId);
     return false;
   }
-  MC_EVT("TTS", "accepted id=%lu text_bytes=%u",
+  reqText_  = text;
+  reqVoice_ = voiceName;
+  for (size_t i = 0; i < kMaxSegments; ++i) {
+    segText_[i] = (i < nSeg) ? segs[i] : String();
+    segKey_[i] = (i < nSeg) ? keys[i] : 0;
+  }
+  segCount_ = (uint8_t)nSeg;
+  MC_EVT("TTS", "accepted id=%lu text_bytes=%u seg=%u%s",
          (unsigned long)speakId,
-         (unsigned)text.length());
+         (unsigned)text.length(),
+         (unsigned)nSeg,
+         cached ? " (cached)" : "");
   currentSpeakId_ = speakId;
   // clear DONE state (for previous id)
   doneSpeakId_ = 0;
@@ -512,11 +639,29 @@ void AzureTts::cancel(uint32_t speakId, const char* reason) {
          (unsigned long)speakId,
          (cancelReason_[0] ? cancelReason_ : "-"));
   // Best-effort: if already PLAYING, try to stop immediately.
+  // (Streaming stops in poll(), which owns the block queue.)
   if (state_ == Playing && currentSpeakId_ == speakId) {
     MC_EVT_D("TTS", "cancel: stop playing id=%lu", (unsigned long)speakId);
     M5.Speaker.stop();
   }
 }
+void AzureTts::prepareSpeaker_() {
+  // Speaker begin if needed
+  if (!M5.Speaker.isEnabled()) {
+    MC_LOGD("TTS", "speaker not enabled -> begin");
+    M5.Speaker.begin();
+  }
+  const int vol = (int)M5.Speaker.getVolume();
+  MC_LOGT("TTS", "spk state: enabled=%d playing=%d vol=%d defaultVol=%d",
+          M5.Speaker.isEnabled() ? 1 : 0,
+          M5.Speaker.isPlaying() ? 1 : 0,
+          vol,
+          (int)defaultVolume_);
+  if (vol == 0 && defaultVolume_ > 0) {
+    MC_LOGD("TTS", "spk vol=0 -> restore %d", (int)defaultVolume_);
+    M5.Speaker.setVolume(defaultVolume_);
+  }
+}
 void AzureTts::poll() {
   // Drive the playback state machine from the main loop.
   if (state_ == Idle) return;
@@ -566,7 +711,7 @@ void AzureTts::poll() {
       makeCanceledReason(r, sizeof(r));
       MC_EVT("TTS", "canceled before play id=%lu reason=%s",
              (unsigned long)currentSpeakId_, r);
-      if (wav_) { free(wav_); wav_ = nullptr; }
+      if (wav_) { payload_arena::release(wav_); wav_ = nullptr; }
       wavLen_ = 0;
       state_ = Idle;
       if (i2sLocked_) {
@@ -600,7 +745,7 @@ void AzureTts::poll() {
                 (unsigned)m.owner(),
                 (unsigned long)m.depth(),
                 m.ownerCallsite() ? m.ownerCallsite() : "");
-        free(wav_);
+        payload_arena::release(wav_);
         wav_ = nullptr;
         wavLen_ = 0;
         state_ = Idle;
@@ -610,29 +755,13 @@ void AzureTts::poll() {
       }
       i2sLocked_ = true;
     }
-    // Speaker begin if needed
-    if (!M5.Speaker.isEnabled()) {
-      MC_LOGD("TTS", "speaker not enabled -> begin");
-      M5.Speaker.begin();
-    }
-    {
-      const int vol = (int)M5.Speaker.getVolume();
-      MC_LOGT("TTS", "spk state: enabled=%d playing=%d vol=%d defaultVol=%d",
-              M5.Speaker.isEnabled() ? 1 : 0,
-              M5.Speaker.isPlaying() ? 1 : 0,
-              vol,
-              (int)defaultVolume_);
-      if (vol == 0 && defaultVolume_ > 0) {
-        MC_LOGD("TTS", "spk vol=0 -> restore %d", (int)defaultVolume_);
-        M5.Speaker.setVolume(defaultVolume_);
-      }
-    }
+    prepareSpeaker_();
     bool okPlay = M5.Speaker.playWav(wav_, wavLen_);
     if (!okPlay) {
       MC_EVT("TTS", "fail id=%lu reason=play_fail wav=%uB",
              (unsigned long)currentSpeakId_, (unsigned)wavLen_);
       MC_LOGE("TTS", "play failed (wav=%uB)", (unsigned)wavLen_);
-      free(wav_);
+      payload_arena::release(wav_);
       wav_ = nullptr;
       wavLen_ = 0;
       state_ = Idle;
@@ -649,6 +778,81 @@ void AzureTts::poll() {
     state_ = Playing;
     return;
   }
+  // ---------- Streaming: feed blocks while the fetch task downloads ----------
+  if (state_ == Streaming) {
+    auto finish = [&](bool ok, const char* reason, const char* unlockSite) {
+      state_ = Idle;
+      if (i2sLocked_) {
+        I2SManager::instance().unlock(unlockSite);
+        i2sLocked_ = false;
+      }
+      if (ok) {
+        last_.ok = true;
+        strncpy(last_.err, "ok", sizeof(last_.err) - 1);
+        last_.err[sizeof(last_.err) - 1] = 0;
+      } else {
+        setLastDrop(reason);
+      }
+      setDone(ok, reason);
+    };
+    if (!streamAbort_ && cancelSpeakId_ != 0 && cancelSpeakId_ == currentSpeakId_) {
+      streamAbortReason_ = "canceled";
+      streamAbort_ = true;
+      xTaskNotifyGive(task_);  // may be waiting for a block
+      if (i2sLocked_) M5.Speaker.stop(kStreamChannel);
+    }
+    if (streamAbort_) {
+      if (!streamEnd_) return;  // the fetch task still owns the blocks
+      char r[24];
+      if (streamAbortReason_ && strcmp(streamAbortReason_, "canceled") == 0) {
+        makeCanceledReason(r, sizeof(r));
+        clearCancel();
+      } else {
+        strncpy(r, streamAbortReason_ ? streamAbortReason_ : "stream_abort", sizeof(r) - 1);
+        r[sizeof(r) - 1] = 0;
+      }
+      MC_EVT("TTS", "stream aborted id=%lu reason=%s", (unsigned long)currentSpeakId_, r);
+      finish(false, r, "TTS.stream_abort");
+      return;
+    }
+    if (!i2sLocked_) {
+      // Start once the first block is in (or the body already ended).
+      if (streamFilled_ == 0 && !streamEnd_) return;
+      if (M5.Speaker.isPlaying()) return;
+      if (!I2SManager::instance().lockForSpeaker("TTS.stream", 4000)) {
+        MC_EVT("TTS", "fail id=%lu reason=i2s_deny (stream)", (unsigned long)currentSpeakId_);
+        streamAbortReason_ = "i2s_deny";
+        streamAbort_ = true;
+        xTaskNotifyGive(task_);
+        return;
+      }
+      i2sLocked_ = true;
+      prepareSpeaker_();
+      MC_EVT("TTS", "play start id=%lu stream rate=%lu",
+             (unsigned long)currentSpeakId_, (unsigned long)streamRate_);
+    }
+    // The speaker holds at most two queued blocks; the older ones are done.
+    const uint32_t inSpk = (uint32_t)M5.Speaker.isPlaying(kStreamChannel);
+    const uint32_t queued = streamQueued_;
+    if (queued - streamFreed_ > inSpk) {
+      streamFreed_ = queued - inSpk;
+      xTaskNotifyGive(task_);  // streamPut_ waits for a free block
+    }
+    uint32_t q = queued;
+    while (q < streamFilled_ && M5.Speaker.isPlaying(kStreamChannel) < 2) {
+      const uint32_t i = q % kStreamBlocks;
+      M5.Speaker.playRaw((const int16_t*)(streamBuf_ + i * kStreamBlockBytes),
+                         streamBlockLen_[i] / 2, streamRate_, false, 1,
+                         kStreamChannel, false);
+      streamQueued_ = ++q;
+    }
+    if (streamEnd_ && q == streamFilled_ && M5.Speaker.isPlaying(kStreamChannel) == 0) {
+      const bool ok = streamOk_;
+      MC_EVT("TTS", "play done id=%lu stream ok=%d", (unsigned long)currentSpeakId_, ok ? 1 : 0);
+      finish(ok, ok ? "ok" : "stream_fail", "TTS.stream_done");
+    }
+    return;
+  }
   // ---------- Playing: wait done ----------
   if (state_ == Playing) {
     // canceled during play
@@ -657,7 +861,7 @@ void AzureTts::poll() {
       makeCanceledReason(r, sizeof(r));
       MC_EVT("TTS", "canceled during play id=%lu reason=%s",
              (unsigned long)currentSpeakId_, r);
-      if (wav_) { free(wav_); wav_ = nullptr; }
+      if (wav_) { payload_arena::release(wav_); wav_ = nullptr; }
       wavLen_ = 0;
       state_ = Idle;
       if (i2sLocked_) {
@@ -670,7 +874,7 @@ void AzureTts::poll() {
       return;
     }
     if (!M5.Speaker.isPlaying()) {
-      if (wav_) { free(wav_); wav_ = nullptr; }
+      if (wav_) { payload_arena::release(wav_); wav_ = nullptr; }
       wavLen_ = 0;
       state_ = Idle;
       if (i2sLocked_) {
@@ -707,110 +911,9 @@ void AzureTts::warmupDnsOnce_() {
     }
   }
 }
-bool AzureTts::fetchTokenOld_(String* outTok) {
-  // Legacy token fetch via regional STS endpoint (still used by some tenants).
-  if (!outTok) return false;
-  outTok->clear();
-  if (key_.length() == 0) {
-    MC_LOGI("TTS_TOKEN", "skip: key empty");
-    return false;
-  }
-  constexpr uint32_t kTokenTimeoutMs = 6000;
-  auto tryUrl = [&](const String& url, const char* label) -> bool {
-    MC_LOGI("TTS_TOKEN", "try %s url=%s", label ? label : "?", url.c_str());
-    WiFiClientSecure c;
-    c.setInsecure();
-    HTTPClient h;
-    h.setReuse(false);
-    h.useHTTP10(false);
-    h.setTimeout(kTokenTimeoutMs);
-    if (!h.begin(c, url)) {
-      MC_LOGI("TTS_TOKEN", "begin failed (%s)", label ? label : "?");
-      h.end();
-      return false;
-    }
-    h.addHeader("Content-type", "application/x-www-form-urlencoded");
-    h.addHeader("Content-length", "0");
-    h.addHeader("Ocp-Apim-Subscription-Key", key_);
-    int code = h.POST((uint8_t*)nullptr, 0);
-    MC_LOGI("TTS_TOKEN", "POST done code=%d (%s)", code, label ? label : "?");
-    if (code == 200) {
-      String tok;
-      int total = h.getSize(); // -1 if unknown (chunked)
-      WiFiClient* s = h.getStreamPtr();
-      const uint32_t t0 = millis();
-      const uint32_t kTimeoutMs = 1500;
-      const size_t kMaxTok = 2048;
-      while (millis() - t0 < kTimeoutMs) {
-        if (!s) break;
-        while (s->available()) {
-          char c = (char)s->read();
-          tok += c;
-          if (tok.length() >= kMaxTok) break;
-        }
-        if (tok.length() >= kMaxTok) break;
-        if (!s->connected() && !s->available()) break;
-        delay(1);
-      }
-      size_t rawLen = tok.length();
-      tok.trim();
-      size_t trimLen = tok.length();
-      MC_LOGI("TTS_TOKEN", "HTTP 200 body_len=%u trimmed=%u size=%d (%s)",
-              (unsigned)rawLen, (unsigned)trimLen, total, label ? label : "?");
-      MC_LOGD("TTS_TOKEN", "body_snip=%s", tokenSnippet_(tok).c_str());
-      h.end();
-      if (tok.length()) {
-        if (outTok) *outTok = tok;
-        return true;
-      }
-      MC_LOGI("TTS_TOKEN", "HTTP 200 but empty body (%s)", label ? label : "?");
-      return false;
-    }
-    String body = h.getString();
-    String err = h.errorToString(code);
-    MC_LOGI("TTS_TOKEN", "HTTP %d (%s) err=%s body_len=%u",
-            code, label ? label : "?", err.c_str(), (unsigned)body.length());
-    h.end();
-    return false;
-  };
-  // 1) region STS (official endpoint)
-  if (region_.length()) {
-    String url = String("https://") + region_ + ".api.cognitive.microsoft.com/sts/v1.0/issueToken";
-    if (tryUrl(url, "region")) return true;
-  } else {
-    MC_LOGI("TTS_TOKEN", "skip: region empty");
-  }
-  // 2) custom host (legacy / some tenants)
-  if (customHost_.length()) {
-    String url = String("https://") + customHost_ + "/sts/v1.0/issueToken";
-    if (tryUrl(url, "custom")) return true;
-  }
-  return false;
-}
 bool AzureTts::ensureToken_() {
-  uint32_t now = millis();
-  if (token_.length() && now < tokenExpireMs_) return true;
-  if (now < tokenFailUntilMs_) return false;
-  if (WiFi.status() != WL_CONNECTED) {
-    MC_LOGI_RL("TTS.token.wifi", 5000, "TTS_TOKEN", "fetch skipped: wifi not connected");
-    return false;
-  }
-  String tok;
-  bool ok = fetchTokenOld_(&tok);
-  if (ok && tok.length()) {
-    token_ = tok;
-    tokenExpireMs_ = now + 9 * 60 * 1000; // 9min cache
-    tokenFailCount_ = 0;
-    MC_LOGI("TTS_TOKEN", "ok (cached 9min)");
-    return true;
-  }
-  // backoff
-  tokenFailCount_ = (uint8_t)min<int>(tokenFailCount_ + 1, 10);
-  uint32_t backoff = 1000u * (1u << min<int>(tokenFailCount_, 6)); // up to ~64s
-  tokenFailUntilMs_ = now + backoff;
-  MC_LOGI_RL("TTS.token.fail", 5000, "TTS_TOKEN",
-             "fail (cooldown=%us)", (unsigned)(backoff / 1000));
-  return false;
+  // Shared token, renewed in the background (azure_token); never waits on STS.
+  return azure_token::get(&token_);
 }
 static String AzureTts_xmlEscape_(const String& s) {
   String o;
@@ -841,10 +944,198 @@ String AzureTts::buildSsml_(const String& text, const String& voice) const {
   ssml += "</voice></speak>";
   return ssml;
 }
-bool AzureTts::fetchWav_(const String& ssml, uint8_t** outBuf, size_t* outLen) {
-  if (!outBuf || !outLen) return false;
+// Task side: append PCM to the block being filled, publishing full blocks.
+// Sleeps until poll() frees a block (task notification); false once
+// playback was aborted.
+bool AzureTts::streamPut_(const uint8_t* p, size_t n) {
+  while (n > 0) {
+    while (streamFilled_ - streamFreed_ >= kStreamBlocks) {
+      if (streamAbort_) return false;
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kStreamWaitMs));
+    }
+    const uint32_t i = streamFilled_ % kStreamBlocks;
+    size_t take = kStreamBlockBytes - streamFillPos_;
+    if (take > n) take = n;
+    memcpy(streamBuf_ + i * kStreamBlockBytes + streamFillPos_, p, take);
+    streamFillPos_ += take;
+    p += take;
+    n -= take;
+    if (streamFillPos_ == kStreamBlockBytes) streamPublish_();
+  }
+  return !streamAbort_;
+}
+void AzureTts::streamPublish_() {
+  const uint32_t i = streamFilled_ % kStreamBlocks;
+  streamBlockLen_[i] = streamFillPos_ & ~1u;  // whole samples only
+  streamFillPos_ = 0;
+  if (streamBlockLen_[i]) ++streamFilled_;
+}
+// Task side: reset the block ring and hand playback to poll(). Later
+// segments of a pipelined utterance join the running stream instead.
+bool AzureTts::streamBegin_(uint32_t rate, uint32_t t0, bool* outStreamed) {
+  if (state_ == Streaming) {
+    if (rate == streamRate_) return true;
+    MC_LOGW("TTS", "stream: segment rate %lu != %lu", (unsigned long)rate,
+            (unsigned long)streamRate_);
+    return false;
+  }
+  streamRate_ = rate;
+  streamFillPos_ = 0;
+  streamFilled_ = 0;
+  streamQueued_ = 0;
+  streamFreed_ = 0;
+  streamOk_ = false;
+  streamAbort_ = false;
+  streamAbortReason_ = nullptr;
+  streamEnd_ = false;
+  last_.streamed = true;
+  last_.ttfbMs = millis() - t0;
+  *outStreamed = true;
+  state_ = Streaming;
+  MC_EVT("TTS", "stream start id=%lu rate=%lu ttfb=%lums",
+         (unsigned long)currentSpeakId_, (unsigned long)rate,
+         (unsigned long)last_.ttfbMs);
+  return true;
+}
+// Task side: the running fetch is done with the blocks.
+void AzureTts::streamFinish_(bool ok) {
+  if (ok && streamFillPos_) streamPublish_();
+  streamOk_ = ok;
+  streamEnd_ = true;  // blocks are poll()'s from here
+}
+bool AzureTts::streamBody_(TtsBodyReader_& br, uint32_t t0, uint8_t** outBuf,
+                           size_t* outLen, bool* outStreamed) {
+  uint8_t head[kStreamHeadMax];
+  size_t headLen = 0;
+  uint32_t rate = 16000;
+  uint32_t dataBytes = 0;
+  size_t dataOff = 0;
+  int hdr = 0;
+  while (hdr == 0) {
+    if (headLen == sizeof(head)) {
+      hdr = -1;
+      break;
+    }
+    const int r = br.read(head + headLen, sizeof(head) - headLen);
+    if (r < 0) return false;
+    if (r == 0) {
+      hdr = -1;
+      break;
+    }
+    headLen += (size_t)r;
+    hdr = parseWavHeader_(head, headLen, &rate, &dataOff, &dataBytes);
+  }
+  if (hdr < 0) {
+    // A segment cannot switch the running stream to a buffered WAV.
+    if (segmented_) return false;
+    MC_LOGD("TTS", "stream: header not PCM16 mono -> buffered");
+    if (!readRest_(br, head, headLen, outBuf, outLen)) return false;
+    salvageChunkedLeakIfNeeded_(outBuf, outLen);
+    return true;
+  }
+  if (dataOff > headLen) dataOff = headLen;
+  if (!streamBegin_(rate, t0, outStreamed)) return false;
+  // Tee the PCM into the flash cache; kept only if the body completes.
+  tts_cache::Writer cw;
+  const bool tee = fetchCacheKey_ && tts_cache::beginWrite(cw, fetchCacheKey_, rate);
+  // Stop at the data chunk size when the header carries one.
+  size_t left = dataBytes ? (size_t)dataBytes : SIZE_MAX;
+  size_t total = 0;
+  bool ok = true;
+  size_t n = headLen - dataOff;
+  if (n > left) n = left;
+  if (n && !streamPut_(head + dataOff, n)) ok = false;
+  if (n && tee) tts_cache::write(cw, head + dataOff, n);
+  left -= n;
+  total += n;
+  uint8_t buf[1024];
+  while (ok && left > 0) {
+    const int r = br.read(buf, (left < sizeof(buf)) ? left : sizeof(buf));
+    if (r == 0) break;
+    if (r < 0) {
+      ok = false;
+      break;
+    }
+    if (!streamPut_(buf, (size_t)r)) ok = false;
+    if (tee) tts_cache::write(cw, buf, (size_t)r);
+    left -= (size_t)r;
+    total += (size_t)r;
+  }
+  if (tee) {
+    // A known data size must be met; otherwise the body end is the end.
+    if (ok && (!dataBytes || total == dataBytes)) tts_cache::commit(cw);
+    else tts_cache::abort(cw);
+  }
+  *outLen = total;
+  // speakSegments_() finishes the stream after the last segment.
+  if (!segmented_) streamFinish_(ok);
+  return ok;
+}
+// Task side: PCM of a WAV already in memory (cached segment) into the stream.
+bool AzureTts::streamWav_(const uint8_t* wav, size_t len, uint32_t t0, bool* outStreamed) {
+  uint32_t rate = 16000;
+  uint32_t dataBytes = 0;
+  size_t dataOff = 0;
+  if (parseWavHeader_(wav, len, &rate, &dataOff, &dataBytes) != 1 || dataOff > len) {
+    return false;
+  }
+  size_t n = len - dataOff;
+  if (dataBytes && dataBytes < n) n = dataBytes;
+  if (!streamBegin_(rate, t0, outStreamed)) return false;
+  return streamPut_(wav + dataOff, n);
+}
+bool AzureTts::ensureStreamBuf_() {
+  if (!streamBuf_) {
+    // Allocated once and kept: the ring is the only big buffer of a stream.
+    streamBuf_ = (uint8_t*)malloc((size_t)kStreamBlocks * kStreamBlockBytes);
+    if (!streamBuf_) MC_LOGW("TTS", "stream buffer alloc failed -> buffered");
+  }
+  return streamBuf_ != nullptr;
+}
+// Task side: one utterance as consecutive sentence requests into one stream.
+// Segment N+1 is requested as soon as N's body is in the ring, i.e. while
+// the ring still holds up to kStreamBlocks of N for the speaker.
+bool AzureTts::speakSegments_(uint32_t t0, size_t* outLen, bool* outStreamed) {
+  *outLen = 0;
+  *outStreamed = false;
+  segmented_ = true;
+  bool ok = true;
+  for (uint8_t i = 0; i < segCount_ && ok; ++i) {
+    if (state_ == Streaming && streamAbort_) {
+      ok = false;
+      break;
+    }
+    const uint32_t ts = millis();
+    uint8_t* buf = nullptr;
+    size_t len = 0;
+    bool fromCache = false;
+    if (segKey_[i] && tts_cache::load(segKey_[i], &buf, &len)) {
+      fromCache = true;
+      ok = streamWav_(buf, len, t0, outStreamed);
+    } else {
+      fetchCacheKey_ = segKey_[i];
+      bool streamed = false;
+      ok = fetchWav_(buildSsml_(segText_[i], reqVoice_), &buf, &len, &streamed) && streamed;
+      fetchCacheKey_ = 0;
+      if (streamed) *outStreamed = true;
+    }
+    payload_arena::release(buf);
+    *outLen += len;
+    MC_LOGD("TTS", "segment %u/%u ok=%d bytes=%u took=%lums%s",
+            (unsigned)(i + 1), (unsigned)segCount_, ok ? 1 : 0, (unsigned)len,
+            (unsigned long)(millis() - ts), fromCache ? " (cache)" : "");
+  }
+  segmented_ = false;
+  if (*outStreamed) streamFinish_(ok);
+  return ok;
+}
+bool AzureTts::fetchWav_(const String& ssml, uint8_t** outBuf, size_t* outLen,
+                         bool* outStreamed) {
+  if (!outBuf || !outLen || !outStreamed) return false;
   *outBuf = nullptr;
   *outLen = 0;
+  *outStreamed = false;
+  const uint32_t t0 = millis();
   if (!endpoint_.length() || !key_.length()) return false;
   if (WiFi.status() != WL_CONNECTED) return false;
   warmupDnsOnce_();
@@ -866,7 +1157,7 @@ bool AzureTts::fetchWav_(const String& ssml, uint8_t** outBuf, size_t* outLen) {
     return false;
   }
   https_.addHeader("Content-Type", "application/ssml+xml");
-  https_.addHeader("X-Microsoft-OutputFormat", "riff-16khz-16bit-mono-pcm");
+  https_.addHeader("X-Microsoft-OutputFormat", kOutputFormat);
   https_.addHeader("User-Agent", "Mining-Stackchan");
   https_.addHeader("Accept", "audio/wav");
   https_.addHeader("Accept-Encoding", "identity");
@@ -888,6 +1179,7 @@ bool AzureTts::fetchWav_(const String& ssml, uint8_t** outBuf, size_t* outLen) {
     (void)body;
     MC_LOGD("TTS", "HTTP %d body_len=%u", code, (unsigned)bodyLen);
     https_.end();
+    if (hasToken && code == 401) azure_token::invalidate();
     disableKeepaliveUntilMs_ = millis() + 5000;
     return false;
   }
@@ -907,13 +1199,33 @@ bool AzureTts::fetchWav_(const String& ssml, uint8_t** outBuf, size_t* outLen) {
     delay(1);
   }
   int total = https_.getSize(); // -1 means unknown (chunked)
+  last_.chunked = (total <= 0);
+  rx_.attach(stream);
+  if (cfg_.streaming && ensureStreamBuf_()) {
+    TtsBodyReader_ br;
+    br.rx_ = &rx_;
+    br.chunked_ = (total <= 0);
+    br.left_ = (total > 0) ? (size_t)total : 0;
+    br.idleMs_ = br.chunked_ ? cfg_.chunkDataIdleTimeoutMs : cfg_.contentReadIdleTimeoutMs;
+    br.abort_ = &streamAbort_;
+    if (state_ != Streaming) streamAbort_ = false;  // keep a running stream's abort
+    const bool ok = streamBody_(br, t0, outBuf, outLen, outStreamed);
+    // Streaming stops at the WAV data size; anything after it (trailing
+    // chunks, chunked terminator) would be read as the next response.
+    if (useKeepAlive && !(ok && br.drain(kStreamDrainMax))) https_.setReuse(false);
+    https_.end();
+    MC_LOGT("TTS", "rx wav bytes=%u (streamed=%d chunked=%d keepAlive=%d)",
+            (unsigned)*outLen, *outStreamed ? 1 : 0, br.chunked_ ? 1 : 0,
+            useKeepAlive ? 1 : 0);
+    return ok;
+  }
   if (total <= 0) {
     uint8_t* buf = nullptr;
     size_t used = 0;
-    bool okChunked = readChunkedBody_(stream, &buf, &used, cfg_.chunkDataIdleTimeoutMs);
+    bool okChunked = readChunkedBody_(rx_, &buf, &used, cfg_.chunkDataIdleTimeoutMs);
     https_.end();
     if (!okChunked) {
-      if (buf) free(buf);
+      payload_arena::release(buf);
       return false;
     }
     salvageChunkedLeakIfNeeded_(&buf, &used);
@@ -924,29 +1236,22 @@ bool AzureTts::fetchWav_(const String& ssml, uint8_t** outBuf, size_t* outLen) {
     return true;
   }
   // content-length known
-  uint8_t* buf = (uint8_t*)malloc((size_t)total);
-  if (!buf) { https_.end(); return false; }
-  size_t got = 0;
-  uint32_t idleStart = millis();
-  while (got < (size_t)total) {
-    int a = stream->available();
-    if (a <= 0) {
-      if (!stream->connected()) break;
-      if (millis() - idleStart > cfg_.contentReadIdleTimeoutMs) break;
-      delay(1);
-      continue;
-    }
-    idleStart = millis();
-    int r = stream->readBytes(buf + got, min<int>(a, (int)((size_t)total - got)));
-    if (r <= 0) break;
-    got += (size_t)r;
+  BodyBuf_ b;
+  if (!b.init() || !b.reserve((size_t)total)) {
+    b.drop();
+    https_.end();
+    return false;
   }
+  const bool okBody = rx_.readExact(b.p_, (size_t)total, cfg_.contentReadIdleTimeoutMs);
   https_.end();
-  if (got != (size_t)total) {
-    free(buf);
+  if (!okBody) {
+    b.drop();
     return false;
   }
-  size_t outN = got;
+  b.used_ = (size_t)total;
+  uint8_t* buf = nullptr;
+  size_t outN = 0;
+  b.take(&buf, &outN);
   salvageChunkedLeakIfNeeded_(&buf, &outN);
   MC_LOGT("TTS", "rx wav bytes=%u (keepAlive=%d)",
           (unsigned)outN, useKeepAlive ? 1 : 0);
@@ -965,19 +1270,41 @@ void AzureTts::taskBody() {
     last_.seq = seq_;
     uint32_t t0 = millis();
     MC_EVT("TTS", "fetch start id=%lu", (unsigned long)currentSpeakId_);
-    String ssml = buildSsml_(reqText_, reqVoice_);
+    String ssml = buildSsml_((segCount_ == 1) ? segText_[0] : reqText_, reqVoice_);
     uint8_t* buf = nullptr;
     size_t len = 0;
-    bool ok = fetchWav_(ssml, &buf, &len);
+    bool streamed = false;
+    bool ok = false;
+    if (segCount_ > 1 && cfg_.streaming && ensureStreamBuf_()) {
+      ok = speakSegments_(t0, &len, &streamed);
+    } else if (segCount_ == 1 && segKey_[0] && tts_cache::load(segKey_[0], &buf, &len)) {
+      ok = true;
+      last_.cached = true;
+    } else {
+      fetchCacheKey_ = (segCount_ == 1) ? segKey_[0] : 0;
+      ok = fetchWav_(ssml, &buf, &len, &streamed);
+      // Buffered result: keep it before handing it to poll() (which frees
+      // it). Streamed fetches were already written while playing.
+      if (ok && !streamed && fetchCacheKey_ && buf && len) {
+        tts_cache::store(fetchCacheKey_, buf, len);
+      }
+      fetchCacheKey_ = 0;
+    }
     last_.fetchMs = millis() - t0;
-    last_.ok = ok;
     last_.bytes = (uint32_t)len;
-    MC_EVT("TTS", "fetch done id=%lu ok=%d http=%d bytes=%lu took=%lums",
+    MC_EVT("TTS", "fetch done id=%lu ok=%d http=%d bytes=%lu took=%lums%s",
            (unsigned long)currentSpeakId_,
            ok ? 1 : 0,
            last_.httpCode,
            (unsigned long)len,
-           (unsigned long)last_.fetchMs);
+           (unsigned long)last_.fetchMs,
+           streamed ? " (streamed)" : (last_.cached ? " (cache)" : ""));
+    // Streamed: poll() already plays it and reports DONE / cancel.
+    if (streamed) {
+      if (ok) lastOkMs_ = millis();
+      continue;
+    }
+    last_.ok = ok;
     auto makeCanceledReason = [&](char* out, size_t outLen) {
       if (!out || outLen == 0) return;
       if (cancelReason_[0]) snprintf(out, outLen, "canceled:%s", cancelReason_);
@@ -1017,7 +1344,7 @@ void AzureTts::taskBody() {
       makeCanceledReason(r, sizeof(r));
       MC_EVT("TTS", "canceled while fetching id=%lu reason=%s",
              (unsigned long)currentSpeakId_, r);
-      if (buf) free(buf);
+      payload_arena::release(buf);
       state_ = Idle;
       setLastDrop(r);
       setDone(false, r);
@@ -1025,7 +1352,7 @@ void AzureTts::taskBody() {
       continue;
     }
     if (!ok || !buf || !len) {
-      if (buf) free(buf);
+      payload_arena::release(buf);
       state_ = Idle;
       MC_EVT("TTS", "fail id=%lu reason=fetch_fail http=%d",
              (unsigned long)currentSpeakId_, last_.httpCode);
@@ -1043,5 +1370,4 @@ void AzureTts::resetSession_() {
   https_.end();
   client_.stop();
   token_ = "";
-  tokenExpireMs_ = 0;
 }
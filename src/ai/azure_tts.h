@@ -5,7 +5,12 @@
 #include <HTTPClient.h>
 #include <WiFiClientSecure.h>
 
+#include <atomic>
+
 #include "config/config.h"
+#include "utils/buffered_reader.h"
+// Incremental HTTP body reader (azure_tts.cpp).
+struct TtsBodyReader_;
 //
 class AzureTts {
 public:
@@ -32,12 +37,17 @@ public:
     uint32_t chunkDataIdleTimeoutMs = 5000;
     // Content-Length read idle timeout
     uint32_t contentReadIdleTimeoutMs = 20000;
+    // play while downloading (PCM16 mono WAV only; else buffered)
+    bool streaming = (MC_TTS_STREAM != 0);
   };
   struct LastResult {
     uint32_t seq = 0;
     bool ok = false;
     bool chunked = false;
     bool keepAlive = true;
+    bool streamed = false;
+    bool cached = false;   // played from the flash cache (ai/tts_cache.h)
+    uint32_t ttfbMs = 0;   // request -> first audio bytes (streamed only)
     int  httpCode = 0;
     uint32_t bytes = 0;
     uint32_t fetchMs = 0;
@@ -50,15 +60,29 @@ public:
   bool testCredentials();
   LastResult lastResult() const;
 private:
-  enum State : uint8_t { Idle, Fetching, Ready, Playing, Error };
+  enum State : uint8_t { Idle, Fetching, Ready, Playing, Error, Streaming };
+  static constexpr uint8_t  kStreamBlocks = MC_TTS_STREAM_BLOCKS;
+  static constexpr uint32_t kStreamBlockBytes = MC_TTS_STREAM_BLOCK_BYTES;
+  static constexpr uint8_t  kMaxSegments = (MC_TTS_SEGMENTS > 1) ? MC_TTS_SEGMENTS : 1;
   static void taskEntry(void* pv);
   void taskBody();
   static String xmlEscape_(const String& s);
   String buildSsml_(const String& text, const String& voice) const;
-  bool fetchWav_(const String& ssml, uint8_t** outBuf, size_t* outLen);
+  // *outStreamed: the body went to the stream blocks (state_ = Streaming).
+  bool fetchWav_(const String& ssml, uint8_t** outBuf, size_t* outLen, bool* outStreamed);
+  bool streamBody_(TtsBodyReader_& br, uint32_t t0, uint8_t** outBuf, size_t* outLen,
+                   bool* outStreamed);
+  bool streamBegin_(uint32_t rate, uint32_t t0, bool* outStreamed);
+  void streamFinish_(bool ok);
+  bool streamWav_(const uint8_t* wav, size_t len, uint32_t t0, bool* outStreamed);
+  bool streamPut_(const uint8_t* p, size_t n);
+  void streamPublish_();
+  bool ensureStreamBuf_();
+  // Sentence segments back to back into one stream (next fetched while playing).
+  bool speakSegments_(uint32_t t0, size_t* outLen, bool* outStreamed);
+  void prepareSpeaker_();
   void warmupDnsOnce_();
   bool ensureToken_();
-  bool fetchTokenOld_(String* outTok);
   void resetSession_();
 private:
   volatile State state_ = Idle;
@@ -73,21 +97,38 @@ private:
   portMUX_TYPE cancelMux_;
   String reqText_;
   String reqVoice_;
+  // reqText_ split by sentence (speakAsync); one segment = not pipelined.
+  String   segText_[kMaxSegments];
+  uint64_t segKey_[kMaxSegments] = {0};  // cache key per segment (0 = not cached)
+  uint8_t  segCount_ = 0;
+  bool     segmented_ = false;   // task: speakSegments_() owns the stream end
+  uint64_t fetchCacheKey_ = 0;   // task: key the running fetch is stored under
   String endpoint_;
   String key_;            // subscription key
   String defaultVoice_;   // default voice
   String region_;
   String customHost_;
   bool dnsWarmed_ = false;
-  String   token_;
-  uint32_t tokenExpireMs_ = 0;
-  uint32_t tokenFailUntilMs_ = 0;
+  String   token_;          // task: copy of the shared token (azure_token)
   uint32_t lastRequestMs_ = 0;
-  uint8_t  tokenFailCount_   = 0;
   uint8_t* wav_    = nullptr;
   size_t   wavLen_ = 0;
+  // Streaming playback: the fetch task fills blocks, poll() hands them to the
+  // speaker. Counters only grow; block i lives at (i % kStreamBlocks).
+  uint8_t* streamBuf_ = nullptr;   // kStreamBlocks * kStreamBlockBytes, kept
+  uint32_t streamBlockLen_[kStreamBlocks] = {0};
+  uint32_t streamFillPos_ = 0;     // task: bytes in the block being filled
+  std::atomic<uint32_t> streamFilled_{0};  // task: blocks ready
+  std::atomic<uint32_t> streamQueued_{0};  // poll: blocks given to the speaker
+  std::atomic<uint32_t> streamFreed_{0};   // poll: blocks the speaker is done with
+  std::atomic<bool> streamEnd_{false};     // task: body finished, blocks released
+  std::atomic<bool> streamOk_{false};
+  std::atomic<bool> streamAbort_{false};   // poll: stop reading
+  const char* streamAbortReason_ = nullptr;
+  uint32_t streamRate_ = 16000;
   WiFiClientSecure client_;
   HTTPClient       https_;
+  BufferedReader   rx_;       // task: response bodies (one at a time)
   bool             keepaliveEnabled_ = true;
   volatile bool sessionResetPending_ = false;
   uint32_t lastOkMs_ = 0;
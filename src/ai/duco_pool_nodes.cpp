@@ -0,0 +1,231 @@
+// Module implementation.
+#include "ai/duco_pool_nodes.h"
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "utils/logging.h"
+
+namespace duco_pool_nodes {
+namespace {
+static const char* kPath = "/duco_nodes.json";
+// Bench time after a failure: kBenchBaseMs << (fails - 1), capped.
+static const uint32_t kBenchBaseMs = 5000;
+static const uint32_t kBenchMaxMs = 120000;
+// RTT assumed for a node that was never measured.
+static const float kUnknownRttMs = 400.0f;
+// Slots spread over nodes scoring within this factor of the best.
+static const float kSpreadFactor = 1.5f;
+// RTT-only updates are written at most this often (flash wear).
+static const uint32_t kSaveEveryMs = 10UL * 60UL * 1000UL;
+
+static Node     g_nodes[kMaxNodes];
+static size_t   g_count = 0;
+static SemaphoreHandle_t g_mutex = nullptr;
+static uint32_t g_lastSaveMs = 0;
+static char     g_poolUrl[96] = {0};
+
+struct Lock_ {
+  Lock_() { if (g_mutex) xSemaphoreTake(g_mutex, portMAX_DELAY); }
+  ~Lock_() { if (g_mutex) xSemaphoreGive(g_mutex); }
+};
+
+static uint32_t epochNow_() {
+  const time_t t = time(nullptr);
+  return (t > 1600000000) ? (uint32_t)t : 0;
+}
+static bool same_(const Node& a, const char* ip, uint16_t port) {
+  return a.port_ == port && strcmp(a.ip_, ip) == 0;
+}
+static int find_(const char* ip, uint16_t port) {
+  for (size_t i = 0; i < g_count; ++i) {
+    if (same_(g_nodes[i], ip, port)) return (int)i;
+  }
+  return -1;
+}
+static bool usable_(Node& n, uint32_t nowMs) {
+  if (n.benchUntilMs_ == 0) return true;
+  if ((int32_t)(nowMs - n.benchUntilMs_) < 0) return false;
+  n.benchUntilMs_ = 0;  // bench over: one more try
+  return true;
+}
+static float score_(const Node& n) {
+  const float rtt = n.rttMs_ ? (float)n.rttMs_ : kUnknownRttMs;
+  const float connFail = n.connects_
+      ? 1.0f - (float)n.connectOk_ / (float)n.connects_ : 0.0f;
+  const uint32_t shares = (uint32_t)n.good_ + n.bad_;
+  const float badRatio = shares ? (float)n.bad_ / (float)shares : 0.0f;
+  return rtt * (1.0f + 3.0f * connFail) * (1.0f + 4.0f * badRatio);
+}
+static void copyStr_(char* dst, size_t cap, const char* src) {
+  strncpy(dst, src ? src : "", cap - 1);
+  dst[cap - 1] = '\0';
+}
+// Caller holds the lock.
+static void save_() {
+  if (!LittleFS.begin(true)) return;
+  JsonDocument doc;
+  doc["url"] = g_poolUrl;
+  JsonArray arr = doc["nodes"].to<JsonArray>();
+  for (size_t i = 0; i < g_count; ++i) {
+    JsonObject o = arr.add<JsonObject>();
+    o["name"] = g_nodes[i].name_;
+    o["ip"]   = g_nodes[i].ip_;
+    o["port"] = g_nodes[i].port_;
+    o["rtt"]  = g_nodes[i].rttMs_;
+    o["ok"]   = g_nodes[i].lastOkEpoch_;
+  }
+  File f = LittleFS.open(kPath, "w");
+  if (!f) {
+    MC_LOGD("DUCO", "node cache: open failed");
+    return;
+  }
+  serializeJson(doc, f);
+  f.close();
+  g_lastSaveMs = millis();
+}
+} // namespace
+
+size_t begin(const char* poolUrl) {
+  if (!g_mutex) g_mutex = xSemaphoreCreateMutex();
+  Lock_ lock;
+  g_count = 0;
+  copyStr_(g_poolUrl, sizeof(g_poolUrl), poolUrl);
+  if (!LittleFS.begin(true) || !LittleFS.exists(kPath)) return 0;
+  File f = LittleFS.open(kPath, "r");
+  if (!f) return 0;
+  JsonDocument doc;
+  const DeserializationError err = deserializeJson(doc, f);
+  f.close();
+  if (err) {
+    MC_LOGD("DUCO", "node cache: parse failed (%s)", err.c_str());
+    return 0;
+  }
+  if (strcmp(doc["url"] | "", g_poolUrl) != 0) return 0;
+  for (JsonObject o : doc["nodes"].as<JsonArray>()) {
+    if (g_count >= kMaxNodes) break;
+    Node n;
+    copyStr_(n.name_, sizeof(n.name_), o["name"] | "");
+    copyStr_(n.ip_, sizeof(n.ip_), o["ip"] | "");
+    n.port_ = o["port"] | 0;
+    n.rttMs_ = o["rtt"] | 0;
+    n.lastOkEpoch_ = o["ok"] | 0;
+    if (n.ip_[0] && n.port_) g_nodes[g_count++] = n;
+  }
+  return g_count;
+}
+
+size_t count() {
+  Lock_ lock;
+  return g_count;
+}
+
+float score(const Node& n) {
+  return score_(n);
+}
+
+bool pick(uint8_t slot, Node& out) {
+  Lock_ lock;
+  const uint32_t nowMs = millis();
+  int ranked[kMaxNodes];
+  float sc[kMaxNodes];
+  size_t m = 0;
+  for (size_t i = 0; i < g_count; ++i) {
+    if (!usable_(g_nodes[i], nowMs)) continue;
+    // Insertion sort by score (at most kMaxNodes entries).
+    const float s = score_(g_nodes[i]);
+    size_t k = m++;
+    while (k > 0 && sc[k - 1] > s) {
+      ranked[k] = ranked[k - 1];
+      sc[k] = sc[k - 1];
+      --k;
+    }
+    ranked[k] = (int)i;
+    sc[k] = s;
+  }
+  if (m == 0) return false;
+  size_t close = 1;
+  while (close < m && sc[close] <= sc[0] * kSpreadFactor) ++close;
+  out = g_nodes[ranked[slot % close]];
+  return true;
+}
+
+void addFromPool(const char* name, const char* ip, uint16_t port) {
+  if (!ip || !ip[0] || !port) return;
+  Lock_ lock;
+  int i = find_(ip, port);
+  if (i >= 0) {
+    copyStr_(g_nodes[i].name_, sizeof(g_nodes[i].name_), name);
+    g_nodes[i].fails_ = 0;  // getPool vouches for it again
+    g_nodes[i].benchUntilMs_ = 0;
+    return;
+  }
+  if (g_count < kMaxNodes) {
+    i = (int)g_count++;
+  } else {
+    // Full: replace the worst-scoring node.
+    i = 0;
+    for (size_t k = 1; k < g_count; ++k) {
+      if (score_(g_nodes[k]) > score_(g_nodes[i])) i = (int)k;
+    }
+  }
+  Node n;
+  copyStr_(n.name_, sizeof(n.name_), name);
+  copyStr_(n.ip_, sizeof(n.ip_), ip);
+  n.port_ = port;
+  g_nodes[i] = n;
+  save_();
+}
+
+void reportConnect(const Node& n, bool ok) {
+  Lock_ lock;
+  const int i = find_(n.ip_, n.port_);
+  if (i < 0) return;
+  Node& e = g_nodes[i];
+  if (e.connects_ < UINT16_MAX) ++e.connects_;
+  if (!ok) {
+    if (e.fails_ < 255) ++e.fails_;
+    const uint8_t sh = (e.fails_ > 6) ? 5 : (uint8_t)(e.fails_ - 1);
+    uint32_t bench = kBenchBaseMs << sh;
+    if (bench > kBenchMaxMs) bench = kBenchMaxMs;
+    e.benchUntilMs_ = millis() + bench;
+    if (!e.benchUntilMs_) e.benchUntilMs_ = 1;
+    MC_EVT("DUCO", "node %s (%s:%u) failed x%u, benched %lus",
+           e.name_, e.ip_, (unsigned)e.port_, (unsigned)e.fails_,
+           (unsigned long)(bench / 1000));
+    return;
+  }
+  const bool firstOk = (e.connectOk_ == 0);
+  if (e.connectOk_ < UINT16_MAX) ++e.connectOk_;
+  e.fails_ = 0;
+  e.benchUntilMs_ = 0;
+  const uint32_t nowEpoch = epochNow_();
+  if (nowEpoch) e.lastOkEpoch_ = nowEpoch;
+  if (firstOk || millis() - g_lastSaveMs >= kSaveEveryMs) save_();
+}
+
+void reportRtt(const Node& n, float rttMs) {
+  if (rttMs < 0.0f) return;
+  if (rttMs > 65535.0f) rttMs = 65535.0f;
+  Lock_ lock;
+  const int i = find_(n.ip_, n.port_);
+  if (i < 0) return;
+  Node& e = g_nodes[i];
+  e.rttMs_ = e.rttMs_ ? (uint16_t)((e.rttMs_ * 3u + (uint32_t)rttMs) / 4u)
+                      : (uint16_t)(rttMs < 1.0f ? 1.0f : rttMs);
+}
+
+void reportShare(const Node& n, bool good) {
+  Lock_ lock;
+  const int i = find_(n.ip_, n.port_);
+  if (i < 0) return;
+  uint16_t& c = good ? g_nodes[i].good_ : g_nodes[i].bad_;
+  if (c < UINT16_MAX) ++c;
+}
+} // namespace duco_pool_nodes
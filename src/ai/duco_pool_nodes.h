@@ -0,0 +1,54 @@
+// Module implementation.
+// DUCO pool node manager: a small candidate set, ranked and persisted to
+// LittleFS (/duco_nodes.json).
+//
+// At boot the miner connects to the cached nodes straight away (no getPool
+// HTTPS round trip) while the list is refreshed from getPool in the
+// background. Each node is scored from its JOB round trip, connect success
+// rate and BAD-share ratio; pick() hands every connection slot the best node,
+// spreading slots over nodes that score close to the best. A node that fails
+// is benched for a while and the caller moves to the next one at once; when
+// every node is benched pick() returns false so the caller asks getPool again.
+//
+// NOTE:
+// - Thread-safe (net tasks + refresh task); state is behind one mutex.
+// - Fixed-size entries, no String. Only name / ip / port / RTT / last
+//   success are saved; the counters restart every boot.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace duco_pool_nodes {
+static constexpr size_t kMaxNodes = 6;
+
+struct Node {
+  char     name_[32] = {0};
+  char     ip_[40] = {0};
+  uint16_t port_ = 0;
+  uint16_t rttMs_ = 0;          // JOB round trip EWMA (0 = not measured)
+  uint32_t lastOkEpoch_ = 0;    // last successful session (0 = unknown / no NTP)
+  uint16_t connects_ = 0;       // connect attempts this boot
+  uint16_t connectOk_ = 0;
+  uint16_t good_ = 0;           // share feedback this boot
+  uint16_t bad_ = 0;
+  uint8_t  fails_ = 0;          // consecutive connect failures
+  uint32_t benchUntilMs_ = 0;   // skipped until then (0 = usable)
+};
+
+// Load the cache; returns the number of cached nodes. A cache written for a
+// different getPool URL (e.g. the local emulator) is ignored.
+size_t begin(const char* poolUrl);
+size_t count();
+// Node for connection slot `slot` (false: nothing usable -> run getPool).
+bool pick(uint8_t slot, Node& out);
+// Merge a getPool answer (an already benched node is given another chance).
+void addFromPool(const char* name, const char* ip, uint16_t port);
+// Connect + banner outcome.
+void reportConnect(const Node& n, bool ok);
+// One JOB request -> job line round trip.
+void reportRtt(const Node& n, float rttMs);
+// Share feedback (BLOCK counts as good).
+void reportShare(const Node& n, bool good);
+// Lower is better; exposed for logs.
+float score(const Node& n);
+} // namespace duco_pool_nodes
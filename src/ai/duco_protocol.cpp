@@ -0,0 +1,97 @@
+// Module implementation.
+#include "ai/duco_protocol.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ai/duco_sha1.h"
+
+namespace duco_protocol {
+namespace {
+static inline bool isSpace_(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+// [b, e) without surrounding whitespace.
+static void trim_(const char*& b, const char*& e) {
+  while (b < e && isSpace_(*b)) ++b;
+  while (e > b && isSpace_(e[-1])) --e;
+}
+static bool startsWith_(const char* b, const char* e, const char* prefix) {
+  const size_t n = strlen(prefix);
+  return (size_t)(e - b) >= n && memcmp(b, prefix, n) == 0;
+}
+} // namespace
+
+size_t buildJobRequest(char* out, size_t cap, const char* user, const char* minerKey) {
+  const int n = snprintf(out, cap, "JOB,%s,LOW,%s\n",
+                         user ? user : "", minerKey ? minerKey : "");
+  return (n > 0 && (size_t)n < cap) ? (size_t)n : 0;
+}
+
+bool parseJob(const char* line, size_t len, Job& out) {
+  out = Job();
+  if (!line) return false;
+  const char* end = line + len;
+  const char* c1 = (const char*)memchr(line, ',', len);
+  if (!c1) return false;
+  const char* c2 = (const char*)memchr(c1 + 1, ',', end - c1 - 1);
+  if (!c2) return false;
+  const char* sb = line;
+  const char* se = c1;
+  trim_(sb, se);
+  const char* xb = c1 + 1;
+  const char* xe = c2;
+  trim_(xb, xe);
+  const char* db = c2 + 1;
+  const char* de = end;
+  trim_(db, de);
+  if (sb == se || (size_t)(se - sb) > kMaxSeed) return false;
+  memcpy(out.seed_, sb, se - sb);
+  out.seed_[se - sb] = '\0';
+  out.seedLen_ = (uint8_t)(se - sb);
+  if (!duco_sha1::decodeTarget(xb, (size_t)(xe - xb), out.target_)) {
+    out = Job();
+    return false;
+  }
+  // Leading decimal digits, like String::toInt().
+  uint32_t d = 0;
+  for (const char* p = db; p < de && *p >= '0' && *p <= '9'; ++p) {
+    d = d * 10u + (uint32_t)(*p - '0');
+  }
+  out.difficulty_ = d ? d : 1;
+  return true;
+}
+
+size_t buildSubmit(char* out, size_t cap, uint32_t nonce, float hps,
+                   const char* banner, const char* version, const char* rig,
+                   const char* chipId, int walletId) {
+  const int n = snprintf(out, cap, "%lu,%.2f,%s %s,%s,DUCOID%s,%d\n",
+                         (unsigned long)nonce, (double)hps,
+                         banner ? banner : "", version ? version : "",
+                         rig ? rig : "", chipId ? chipId : "", walletId);
+  return (n > 0 && (size_t)n < cap) ? (size_t)n : 0;
+}
+
+Feedback parseFeedback(const char* line, size_t len) {
+  if (!line) return Feedback::Unknown;
+  const char* b = line;
+  const char* e = line + len;
+  trim_(b, e);
+  if (startsWith_(b, e, "GOOD"))  return Feedback::Good;
+  if (startsWith_(b, e, "BLOCK")) return Feedback::Block;
+  if (startsWith_(b, e, "BAD"))   return Feedback::Bad;
+  return Feedback::Unknown;
+}
+
+size_t trimCopy(char* out, size_t cap, const char* line, size_t len) {
+  if (!out || cap == 0) return 0;
+  const char* b = line ? line : "";
+  const char* e = b + (line ? len : 0);
+  trim_(b, e);
+  size_t n = (size_t)(e - b);
+  if (n > cap - 1) n = cap - 1;
+  memcpy(out, b, n);
+  out[n] = '\0';
+  return n;
+}
+} // namespace duco_protocol
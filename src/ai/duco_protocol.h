@@ -0,0 +1,43 @@
+// Module implementation.
+// DUCO pool line codec (fixed buffers, no heap).
+//
+//   -> JOB,<user>,LOW,<minerKey>\n
+//   <- <prevHash>,<expectedHash>,<difficulty>\n
+//   -> <nonce>,<hashrate>,<banner> <version>,<rig>,DUCOID<chip>,<walletId>\n
+//   <- GOOD | BAD[,reason] | BLOCK ...\n
+//
+// NOTE:
+// - No Arduino / String here; callers pass stack or static buffers.
+// - build*() return the line length (including '\n'), or 0 if it does not fit.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace duco_protocol {
+// Longest line we expect from the pool (job or feedback).
+static constexpr size_t kMaxLine = 128;
+// Seed kept verbatim (the pool sends 40 hex chars).
+static constexpr size_t kMaxSeed = 63;
+
+struct Job {
+  char     seed_[kMaxSeed + 1] = {0};
+  uint8_t  seedLen_ = 0;
+  uint32_t target_[5] = {0};  // expected digest as SHA1 state words
+  uint32_t difficulty_ = 0;
+};
+
+enum class Feedback : uint8_t { Good, Bad, Block, Unknown };
+
+size_t buildJobRequest(char* out, size_t cap, const char* user, const char* minerKey);
+// line: one job line with or without the trailing "\r\n". Difficulty <= 0
+// or missing becomes 1 (same as the pool's old String parser). False when
+// the seed is missing / too long or the expected hash is not 40 hex digits:
+// no nonce can match such a target, so the job must not be mined.
+bool parseJob(const char* line, size_t len, Job& out);
+size_t buildSubmit(char* out, size_t cap, uint32_t nonce, float hps,
+                   const char* banner, const char* version, const char* rig,
+                   const char* chipId, int walletId);
+Feedback parseFeedback(const char* line, size_t len);
+// Copy of line without leading/trailing whitespace (for logs); returns length.
+size_t trimCopy(char* out, size_t cap, const char* line, size_t len);
+} // namespace duco_protocol
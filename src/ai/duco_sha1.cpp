@@ -0,0 +1,328 @@
+// Module implementation.
+#include "ai/duco_sha1.h"
+
+#include <string.h>
+
+namespace duco_sha1 {
+namespace {
+static const uint32_t kIv[5] = {
+  0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u
+};
+static const uint32_t kK0 = 0x5A827999u;
+static const uint32_t kK1 = 0x6ED9EBA1u;
+static const uint32_t kK2 = 0x8F1BBCDCu;
+static const uint32_t kK3 = 0xCA62C1D6u;
+static inline uint32_t rotl_(uint32_t x, int n) {
+  return (x << n) | (x >> (32 - n));
+}
+static inline uint32_t rd32be_(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8)  |  (uint32_t)p[3];
+}
+// One SHA1 round; f is the round function result for (b, c, d).
+static inline void step_(uint32_t& a, uint32_t& b, uint32_t& c,
+                         uint32_t& d, uint32_t& e,
+                         uint32_t f, uint32_t k, uint32_t w) {
+  const uint32_t t = rotl_(a, 5) + f + e + k + w;
+  e = d;
+  d = c;
+  c = rotl_(b, 30);
+  b = a;
+  a = t;
+}
+static inline uint32_t fCh_(uint32_t b, uint32_t c, uint32_t d) {
+  return d ^ (b & (c ^ d));
+}
+static inline uint32_t fParity_(uint32_t b, uint32_t c, uint32_t d) {
+  return b ^ c ^ d;
+}
+static inline uint32_t fMaj_(uint32_t b, uint32_t c, uint32_t d) {
+  return (b & c) | (d & (b | c));
+}
+// Message schedule on a 16-word ring: W[t] for t >= 16.
+static inline uint32_t expand_(uint32_t* w, int t) {
+  const uint32_t x = rotl_(w[(t + 13) & 15] ^ w[(t + 8) & 15] ^
+                           w[(t + 2) & 15] ^ w[t & 15], 1);
+  w[t & 15] = x;
+  return x;
+}
+// Rounds fixedWords..79 over a full block (w[0..15]) from the midstate.
+static void compress_(const Midstate& ms, uint32_t* w, uint32_t out[5]) {
+  const int fixed = ms.fixedWords_;
+  uint32_t a = ms.a_, b = ms.b_, c = ms.c_, d = ms.d_, e = ms.e_;
+  int t = fixed;
+  for (; t < 16; ++t) {
+    step_(a, b, c, d, e, fCh_(b, c, d), kK0, w[t]);
+  }
+  if (fixed >= 10) {
+    w[0] = ms.w16_;
+    w[1] = ms.w17_;
+    step_(a, b, c, d, e, fCh_(b, c, d), kK0, ms.w16_);
+    step_(a, b, c, d, e, fCh_(b, c, d), kK0, ms.w17_);
+    t = 18;
+  }
+  for (; t < 20; ++t) {
+    step_(a, b, c, d, e, fCh_(b, c, d), kK0, expand_(w, t));
+  }
+  for (; t < 40; ++t) {
+    step_(a, b, c, d, e, fParity_(b, c, d), kK1, expand_(w, t));
+  }
+  for (; t < 60; ++t) {
+    step_(a, b, c, d, e, fMaj_(b, c, d), kK2, expand_(w, t));
+  }
+  for (; t < 80; ++t) {
+    step_(a, b, c, d, e, fParity_(b, c, d), kK3, expand_(w, t));
+  }
+  out[0] = kIv[0] + a;
+  out[1] = kIv[1] + b;
+  out[2] = kIv[2] + c;
+  out[3] = kIv[3] + d;
+  out[4] = kIv[4] + e;
+}
+// Lane-major round helpers for compressLanes_: x[l] is lane l.
+template <int N>
+static inline void stepLanes_(uint32_t* a, uint32_t* b, uint32_t* c,
+                              uint32_t* d, uint32_t* e,
+                              const uint32_t* f, uint32_t k, const uint32_t* w) {
+  for (int l = 0; l < N; ++l) {
+    const uint32_t t = rotl_(a[l], 5) + f[l] + e[l] + k + w[l];
+    e[l] = d[l];
+    d[l] = c[l];
+    c[l] = rotl_(b[l], 30);
+    b[l] = a[l];
+    a[l] = t;
+  }
+}
+template <int N>
+static inline const uint32_t* expandLanes_(uint32_t (*w)[N], int t) {
+  uint32_t* x = w[t & 15];
+  const uint32_t* w13 = w[(t + 13) & 15];
+  const uint32_t* w8 = w[(t + 8) & 15];
+  const uint32_t* w2 = w[(t + 2) & 15];
+  for (int l = 0; l < N; ++l) x[l] = rotl_(w13[l] ^ w8[l] ^ w2[l] ^ x[l], 1);
+  return x;
+}
+// compress_ for N blocks that share the midstate; w[t][lane].
+template <int N>
+static void compressLanes_(const Midstate& ms, uint32_t (*w)[N], uint32_t (*out)[5]) {
+  const int fixed = ms.fixedWords_;
+  uint32_t a[N], b[N], c[N], d[N], e[N], f[N];
+  for (int l = 0; l < N; ++l) {
+    a[l] = ms.a_; b[l] = ms.b_; c[l] = ms.c_; d[l] = ms.d_; e[l] = ms.e_;
+  }
+  int t = fixed;
+  for (; t < 16; ++t) {
+    for (int l = 0; l < N; ++l) f[l] = fCh_(b[l], c[l], d[l]);
+    stepLanes_<N>(a, b, c, d, e, f, kK0, w[t]);
+  }
+  if (fixed >= 10) {
+    for (int l = 0; l < N; ++l) {
+      w[0][l] = ms.w16_;
+      w[1][l] = ms.w17_;
+    }
+    for (int i = 0; i < 2; ++i) {
+      for (int l = 0; l < N; ++l) f[l] = fCh_(b[l], c[l], d[l]);
+      stepLanes_<N>(a, b, c, d, e, f, kK0, w[i]);
+    }
+    t = 18;
+  }
+  for (; t < 20; ++t) {
+    for (int l = 0; l < N; ++l) f[l] = fCh_(b[l], c[l], d[l]);
+    stepLanes_<N>(a, b, c, d, e, f, kK0, expandLanes_<N>(w, t));
+  }
+  for (; t < 40; ++t) {
+    for (int l = 0; l < N; ++l) f[l] = fParity_(b[l], c[l], d[l]);
+    stepLanes_<N>(a, b, c, d, e, f, kK1, expandLanes_<N>(w, t));
+  }
+  for (; t < 60; ++t) {
+    for (int l = 0; l < N; ++l) f[l] = fMaj_(b[l], c[l], d[l]);
+    stepLanes_<N>(a, b, c, d, e, f, kK2, expandLanes_<N>(w, t));
+  }
+  for (; t < 80; ++t) {
+    for (int l = 0; l < N; ++l) f[l] = fParity_(b[l], c[l], d[l]);
+    stepLanes_<N>(a, b, c, d, e, f, kK3, expandLanes_<N>(w, t));
+  }
+  for (int l = 0; l < N; ++l) {
+    out[l][0] = kIv[0] + a[l];
+    out[l][1] = kIv[1] + b[l];
+    out[l][2] = kIv[2] + c[l];
+    out[l][3] = kIv[3] + d[l];
+    out[l][4] = kIv[4] + e[l];
+  }
+}
+// Tail words [seed tail][digits][0x80][0...] up to W12 -> w[fixed..12].
+static void packTail_(uint32_t* w, int fixed, const uint8_t* seedTail,
+                      size_t seedTailLen, const char* digits, size_t len) {
+  uint8_t tail[52];
+  const size_t tailLen = 52 - (size_t)fixed * 4;
+  memset(tail, 0, tailLen);
+  memcpy(tail, seedTail, seedTailLen);
+  memcpy(tail + seedTailLen, digits, len);
+  tail[seedTailLen + len] = 0x80;
+  for (int i = fixed; i < 13; ++i) w[i] = rd32be_(tail + (i - fixed) * 4);
+}
+} // namespace
+
+bool prepare(Midstate& ms, const char* seed, size_t seedLen) {
+  ms = Midstate();
+  if (!seed || seedLen > kMaxSeedLen) return false;
+  const uint8_t* p = (const uint8_t*)seed;
+  ms.seedLen_ = (uint8_t)seedLen;
+  ms.fixedWords_ = (uint8_t)(seedLen / 4);
+  for (int i = 0; i < ms.fixedWords_; ++i) {
+    ms.w_[i] = rd32be_(p + i * 4);
+  }
+  memcpy(ms.seedTail_, p + ms.fixedWords_ * 4, seedLen % 4);
+  // Rounds that only read seed words (always < 16, i.e. the Ch group).
+  uint32_t a = kIv[0], b = kIv[1], c = kIv[2], d = kIv[3], e = kIv[4];
+  for (int t = 0; t < ms.fixedWords_; ++t) {
+    step_(a, b, c, d, e, fCh_(b, c, d), kK0, ms.w_[t]);
+  }
+  ms.a_ = a; ms.b_ = b; ms.c_ = c; ms.d_ = d; ms.e_ = e;
+  // W13/W14 are zero for every supported seed, so W16/W17 only depend on the
+  // seed once W0..W9 are fixed (the 40-char DUCO seed case).
+  if (ms.fixedWords_ >= 10) {
+    ms.w16_ = rotl_(ms.w_[8] ^ ms.w_[2] ^ ms.w_[0], 1);
+    ms.w17_ = rotl_(ms.w_[9] ^ ms.w_[3] ^ ms.w_[1], 1);
+  }
+  return true;
+}
+
+void hash(const Midstate& ms, const char* nonce, size_t nonceLen, uint32_t out[5]) {
+  if (nonceLen > kMaxNonceDigits) nonceLen = kMaxNonceDigits;
+  const int fixed = ms.fixedWords_;
+  uint32_t w[16];
+  for (int i = 0; i < fixed; ++i) w[i] = ms.w_[i];
+  packTail_(w, fixed, ms.seedTail_, ms.seedLen_ - (size_t)fixed * 4,
+            nonce, nonceLen);
+  w[13] = 0;
+  w[14] = 0;
+  w[15] = (uint32_t)((ms.seedLen_ + nonceLen) * 8);
+  compress_(ms, w, out);
+}
+
+void hash(const Midstate& ms, const NonceCursor& cur, uint32_t out[5]) {
+  const int fixed = ms.fixedWords_;
+  uint32_t w[16];
+  for (int i = 0; i < fixed; ++i) w[i] = ms.w_[i];
+  for (int i = fixed; i < 13; ++i) w[i] = cur.w_[i];
+  w[13] = 0;
+  w[14] = 0;
+  w[15] = cur.bitLen_;
+  compress_(ms, w, out);
+}
+
+template <int kLanes>
+void hashLanes(const Midstate& ms, const NonceCursor* cur, uint32_t (*out)[5]) {
+  static_assert(kLanes >= 2 && kLanes <= 4, "hashLanes: 2..4 lanes");
+  const int fixed = ms.fixedWords_;
+  uint32_t w[16][kLanes];
+  for (int i = 0; i < fixed; ++i) {
+    for (int l = 0; l < kLanes; ++l) w[i][l] = ms.w_[i];
+  }
+  for (int i = fixed; i < 13; ++i) {
+    for (int l = 0; l < kLanes; ++l) w[i][l] = cur[l].w_[i];
+  }
+  for (int l = 0; l < kLanes; ++l) {
+    w[13][l] = 0;
+    w[14][l] = 0;
+    w[15][l] = cur[l].bitLen_;
+  }
+  compressLanes_<kLanes>(ms, w, out);
+}
+template void hashLanes<3>(const Midstate&, const NonceCursor*, uint32_t (*)[5]);
+template void hashLanes<4>(const Midstate&, const NonceCursor*, uint32_t (*)[5]);
+
+void NonceCursor::reset(const Midstate& ms, uint32_t nonce) {
+  memcpy(seedTail_, ms.seedTail_, sizeof(seedTail_));
+  seedLen_ = ms.seedLen_;
+  fixedWords_ = ms.fixedWords_;
+  value_ = nonce;
+  layout_();
+}
+
+void NonceCursor::layout_() {
+  // Render value_ once (only on reset and when the digit count grows).
+  char tmp[kMaxNonceDigits];
+  char digits[kMaxNonceDigits];
+  uint32_t v = value_;
+  uint8_t n = 0;
+  do {
+    tmp[n++] = (char)('0' + (v % 10));
+    v /= 10;
+  } while (v);
+  for (uint8_t i = 0; i < n; ++i) digits[i] = tmp[n - 1 - i];
+  len_ = n;
+  digitPos_ = (uint8_t)(seedLen_ - fixedWords_ * 4);
+  packTail_(w_, fixedWords_, seedTail_, digitPos_, digits, len_);
+  bitLen_ = (uint32_t)((seedLen_ + len_) * 8);
+}
+
+void NonceCursor::next(uint8_t step) {
+  value_ += step;
+  // Walk digits right to left inside the big-endian words: add the step to
+  // the last digit, then carry 1 while a digit passes '9'. Byte i of the
+  // tail lives in w_[fixed + i / 4].
+  int i = digitPos_ + len_ - 1;
+  uint32_t add = step;
+  for (;;) {
+    uint32_t& word = w_[fixedWords_ + (i >> 2)];
+    const int shift = (3 - (i & 3)) * 8;
+    const uint32_t digit = ((word >> shift) & 0xFFu) - (uint32_t)'0';
+    if (digit + add <= 9u) {
+      word += (add << shift);
+      return;
+    }
+    word -= ((10u - add) << shift);
+    add = 1;
+    if (i == digitPos_) {
+      // 99..9 -> 100..0: one more digit, moves the 0x80 pad and W15.
+      layout_();
+      return;
+    }
+    --i;
+  }
+}
+
+uint8_t NonceCursor::copyDigits(char* dst) const {
+  for (uint8_t k = 0; k < len_; ++k) {
+    const int i = digitPos_ + k;
+    dst[k] = (char)((w_[fixedWords_ + (i >> 2)] >> ((3 - (i & 3)) * 8)) & 0xFFu);
+  }
+  return len_;
+}
+
+void digestToBytes(const uint32_t h[5], uint8_t out[20]) {
+  for (int i = 0; i < 5; ++i) {
+    out[i * 4 + 0] = (uint8_t)(h[i] >> 24);
+    out[i * 4 + 1] = (uint8_t)(h[i] >> 16);
+    out[i * 4 + 2] = (uint8_t)(h[i] >> 8);
+    out[i * 4 + 3] = (uint8_t)h[i];
+  }
+}
+
+void bytesToDigest(const uint8_t in[20], uint32_t h[5]) {
+  for (int i = 0; i < 5; ++i) h[i] = rd32be_(in + i * 4);
+}
+
+bool decodeTarget(const char* hex, size_t len, uint32_t out[5]) {
+  for (int i = 0; i < 5; ++i) out[i] = 0;
+  if (!hex) return false;
+  bool ok = (len == 40);
+  const size_t n = (len < 40) ? len : 40;
+  for (size_t i = 0; i < n; ++i) {
+    const uint8_t c = (uint8_t)hex[i];
+    uint32_t v;
+    if (c >= '0' && c <= '9') {
+      v = c - '0';
+    } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+      v = (c | 0x20) - 'a' + 10;
+    } else {
+      v = 0;
+      ok = false;
+    }
+    out[i >> 3] |= v << ((7 - (i & 7)) * 4);
+  }
+  return ok;
+}
+} // namespace duco_sha1
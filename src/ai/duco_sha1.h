@@ -0,0 +1,111 @@
+// Module implementation.
+// DUCO-S1 SHA1 kernel: SHA1(seed + decimal nonce) with a per-job midstate.
+//
+// The seed (previous block hash, 40 hex chars) is fixed for a whole job and
+// only the trailing decimal nonce changes, so the message always fits a single
+// 64-byte block and every round that only touches seed words can be run once
+// per job. prepare() does that work; hash() runs the nonce-dependent rounds.
+//
+// NOTE:
+// - Pure C++ (no Arduino / mbedTLS) so the same kernel builds on the host.
+// - Digest words are big-endian SHA1 state words (h0..h4).
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace duco_sha1 {
+// Longest nonce rendered in decimal (UINT32_MAX).
+static constexpr size_t kMaxNonceDigits = 10;
+// Longest seed that keeps seed + nonce + 0x80 inside W0..W12 (single block,
+// W13/W14 always zero so W16/W17 can be precomputed).
+static constexpr size_t kMaxSeedLen = 41;
+
+struct Midstate {
+  uint32_t a_ = 0, b_ = 0, c_ = 0, d_ = 0, e_ = 0;  // after fixed rounds
+  uint32_t w_[16] = {0};   // W0..W(fixedWords_-1) are valid
+  uint32_t w16_ = 0;       // W16 (seed-only)
+  uint32_t w17_ = 0;       // W17 (seed-only)
+  uint8_t  seedTail_[4] = {0};  // seed bytes that share a word with the nonce
+  uint8_t  seedLen_ = 0;
+  uint8_t  fixedWords_ = 0;     // rounds 0..fixedWords_-1 are precomputed
+};
+
+// Division-based decimal render (no NUL); returns the digit count. The
+// reference for NonceCursor and the mbedTLS fallback's per-hash nonce text.
+static inline int u32ToDec(char* dst, uint32_t v) {
+  if (v == 0) {
+    dst[0] = '0';
+    return 1;
+  }
+  char tmp[kMaxNonceDigits];
+  int n = 0;
+  while (v) {
+    tmp[n++] = char('0' + (v % 10));
+    v /= 10;
+  }
+  for (int i = 0; i < n; ++i) {
+    dst[i] = tmp[n - 1 - i];
+  }
+  return n;
+}
+
+// Decimal nonce kept in place inside the message words (W fixed..12).
+// next() bumps the ASCII digits with carry, so the hot loop never divides;
+// usually only one byte of one word changes. Length grows at powers of ten.
+class NonceCursor {
+public:
+  void reset(const Midstate& ms, uint32_t nonce);
+  // value += step (1..9): one digit add with carry, no division.
+  void next(uint8_t step = 1);
+  uint32_t value() const { return value_; }
+  uint8_t length() const { return len_; }
+  // Copy the current digits (no NUL); returns the digit count.
+  uint8_t copyDigits(char* dst) const;
+private:
+  friend void hash(const Midstate& ms, const NonceCursor& cur, uint32_t out[5]);
+  template <int kLanes>
+  friend void hashLanes(const Midstate& ms, const NonceCursor* cur,
+                        uint32_t (*out)[5]);
+  void layout_();
+  uint32_t w_[16] = {0};   // only W[fixedWords_..12] are used
+  uint32_t bitLen_ = 0;    // W15
+  uint32_t value_ = 0;
+  uint8_t  seedTail_[4] = {0};
+  uint8_t  seedLen_ = 0;
+  uint8_t  fixedWords_ = 0;
+  uint8_t  digitPos_ = 0;  // byte offset of the first digit in the block
+  uint8_t  len_ = 0;
+};
+
+// Precompute the seed-only part of the block. Returns false when the seed
+// does not fit the single-block layout (caller should fall back).
+bool prepare(Midstate& ms, const char* seed, size_t seedLen);
+// SHA1(seed + nonce) -> out[5] (state words).
+void hash(const Midstate& ms, const char* nonce, size_t nonceLen, uint32_t out[5]);
+// Same, with the nonce taken from a cursor reset() against the same midstate.
+void hash(const Midstate& ms, const NonceCursor& cur, uint32_t out[5]);
+// kLanes nonces in one pass (cur[0..kLanes-1] -> out[0..kLanes-1]). Every
+// round runs once per lane back to back, so the independent dependency
+// chains fill each other's latency on Xtensa; the state is kept lane-major
+// so the host compiler can turn each round into vector ops.
+// Built for kLanes = 3, 4 (explicit instances in duco_sha1.cpp); two lanes
+// do not hide enough latency to pay for the lane-major state and ran slower
+// than the scalar midstate path on the bench.
+template <int kLanes>
+void hashLanes(const Midstate& ms, const NonceCursor* cur, uint32_t (*out)[5]);
+extern template void hashLanes<3>(const Midstate&, const NonceCursor*, uint32_t (*)[5]);
+extern template void hashLanes<4>(const Midstate&, const NonceCursor*, uint32_t (*)[5]);
+// State words -> 20-byte digest (big-endian).
+void digestToBytes(const uint32_t h[5], uint8_t out[20]);
+// 20-byte digest -> state words (for the mbedTLS fallback path).
+void bytesToDigest(const uint8_t in[20], uint32_t h[5]);
+// 40 hex chars (either case) -> state words, decoded once per job so the
+// solver can compare h[0] straight from the state. Returns false (and leaves
+// bad nibbles as 0) when the text is not exactly 40 hex digits.
+bool decodeTarget(const char* hex, size_t len, uint32_t out[5]);
+// Early-out compare: one integer compare for almost every candidate.
+static inline bool matches(const uint32_t h[5], const uint32_t target[5]) {
+  return h[0] == target[0] && h[1] == target[1] && h[2] == target[2] &&
+         h[3] == target[3] && h[4] == target[4];
+}
+} // namespace duco_sha1
@@ -0,0 +1,203 @@
+// Module implementation.
+#include "ai/mining_series.h"
+
+#include <math.h>
+
+#include <initializer_list>
+
+namespace {
+// EWMA time constants (seconds), indexed by SeriesMetric. Shares arrive a few
+// per minute, so their rate needs a much longer window than the hashrate.
+static const float kEwmaTauS[4] = {10.0f, 300.0f, 300.0f, 30.0f};
+// A longer gap than this is not replayed second by second.
+static const uint32_t kMaxReplaySecs = 3600;
+
+static uint16_t sat16_(uint32_t v) {
+  return (v > 0xFFFFu) ? (uint16_t)0xFFFFu : (uint16_t)v;
+}
+} // namespace
+
+void MiningSeries::reset() {
+  // Field by field: the rings point into this object's own arrays.
+  for (Ring* r : {&rs_, &rm_, &rh_}) r->head_ = r->count_ = 0;
+  accMin_ = Acc();
+  accHour_ = Acc();
+  for (float& e : ewma_) e = 0.0f;
+  primed_ = false;
+}
+
+void MiningSeries::put_(Ring& r, const Bucket& b) {
+  r.buf_[r.head_] = b;
+  r.head_ = (r.head_ + 1) % r.cap_;
+  if (r.count_ < r.cap_) ++r.count_;
+}
+
+void MiningSeries::add_(Acc& a, const Bucket& b) {
+  a.hashes_ += b.hashes_;
+  a.shares_ += b.shares_;
+  a.rejects_ += b.rejects_;
+  if (b.pingMs_) {
+    a.pingSum_ += b.pingMs_;
+    ++a.pingN_;
+  }
+  a.secs_ += b.secs_;
+  ++a.parts_;
+}
+
+MiningSeries::Bucket MiningSeries::close_(Acc& a) {
+  Bucket b;
+  b.hashes_ = (a.hashes_ > 0xFFFFFFFFull) ? 0xFFFFFFFFu : (uint32_t)a.hashes_;
+  b.shares_ = sat16_(a.shares_);
+  b.rejects_ = sat16_(a.rejects_);
+  b.pingMs_ = a.pingN_ ? sat16_(a.pingSum_ / a.pingN_) : 0;
+  b.secs_ = sat16_(a.secs_);
+  a = Acc();
+  return b;
+}
+
+void MiningSeries::pushSecond_(uint32_t hashes, uint32_t shares, uint32_t rejects,
+                               float pingMs) {
+  Bucket b;
+  b.hashes_ = hashes;
+  b.shares_ = sat16_(shares);
+  b.rejects_ = sat16_(rejects);
+  b.pingMs_ = (pingMs > 0.0f) ? sat16_((uint32_t)(pingMs + 0.5f)) : 0;
+  b.secs_ = 1;
+  put_(rs_, b);
+
+  add_(accMin_, b);
+  if (accMin_.parts_ >= 60) {
+    const Bucket m = close_(accMin_);
+    put_(rm_, m);
+    add_(accHour_, m);
+    if (accHour_.parts_ >= 60) put_(rh_, close_(accHour_));
+  }
+
+  for (uint8_t i = 0; i < 4; ++i) {
+    const SeriesMetric m = (SeriesMetric)i;
+    if (m == SeriesMetric::PingMs && !b.pingMs_) continue;
+    const float v = value_(b, m);
+    if (!primed_) {
+      ewma_[i] = v;
+      continue;
+    }
+    const float a = 1.0f - expf(-1.0f / kEwmaTauS[i]);
+    ewma_[i] += a * (v - ewma_[i]);
+  }
+  primed_ = true;
+}
+
+void MiningSeries::push(uint32_t secs, uint32_t hashes, uint32_t shares,
+                        uint32_t rejects, float pingMs) {
+  if (secs == 0) return;
+  if (secs == 1) {
+    pushSecond_(hashes, shares, rejects, pingMs);
+    return;
+  }
+  const uint32_t n = (secs > kMaxReplaySecs) ? kMaxReplaySecs : secs;
+  // Spread evenly; the remainders land in the last second.
+  const uint32_t h = hashes / n, s = shares / n, r = rejects / n;
+  for (uint32_t i = 0; i + 1 < n; ++i) pushSecond_(h, s, r, pingMs);
+  pushSecond_(hashes - h * (n - 1), shares - s * (n - 1), rejects - r * (n - 1),
+              pingMs);
+}
+
+float MiningSeries::value_(const Bucket& b, SeriesMetric m) {
+  const float secs = b.secs_ ? (float)b.secs_ : 1.0f;
+  switch (m) {
+    case SeriesMetric::HashRate:   return (float)b.hashes_ / secs;
+    case SeriesMetric::ShareRate:  return (float)b.shares_ * 60.0f / secs;
+    case SeriesMetric::RejectRate: return (float)b.rejects_ * 60.0f / secs;
+    case SeriesMetric::PingMs:     return (float)b.pingMs_;
+    default: return 0.0f;
+  }
+}
+
+const MiningSeries::Ring& MiningSeries::ring_(SeriesScale s) const {
+  switch (s) {
+    case SeriesScale::Minute: return rm_;
+    case SeriesScale::Hour:   return rh_;
+    default: return rs_;
+  }
+}
+
+size_t MiningSeries::size(SeriesScale s) const {
+  return ring_(s).count_;
+}
+
+float MiningSeries::ewma(SeriesMetric m) const {
+  return ewma_[(uint8_t)m & 3];
+}
+
+// Newest first into out[] (capacity kSeconds, the largest ring). Buckets
+// without a ping sample are skipped for PingMs.
+size_t MiningSeries::gather_(SeriesScale s, SeriesMetric m, size_t lastN,
+                             float* out) const {
+  const Ring& r = ring_(s);
+  const size_t n = (lastN == 0 || lastN > r.count_) ? r.count_ : lastN;
+  size_t k = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const Bucket& b = r.buf_[(r.head_ + r.cap_ - 1 - i) % r.cap_];
+    if (m == SeriesMetric::PingMs && !b.pingMs_) continue;
+    out[k++] = value_(b, m);
+  }
+  return k;
+}
+
+float MiningSeries::latest(SeriesScale s, SeriesMetric m) const {
+  float v[kSeconds];
+  return gather_(s, m, 1, v) ? v[0] : 0.0f;
+}
+
+float MiningSeries::minOf(SeriesScale s, SeriesMetric m, size_t lastN) const {
+  float v[kSeconds];
+  const size_t n = gather_(s, m, lastN, v);
+  if (n == 0) return 0.0f;
+  float out = v[0];
+  for (size_t i = 1; i < n; ++i) {
+    if (v[i] < out) out = v[i];
+  }
+  return out;
+}
+
+float MiningSeries::maxOf(SeriesScale s, SeriesMetric m, size_t lastN) const {
+  float v[kSeconds];
+  const size_t n = gather_(s, m, lastN, v);
+  if (n == 0) return 0.0f;
+  float out = v[0];
+  for (size_t i = 1; i < n; ++i) {
+    if (v[i] > out) out = v[i];
+  }
+  return out;
+}
+
+float MiningSeries::mean(SeriesScale s, SeriesMetric m, size_t lastN) const {
+  float v[kSeconds];
+  const size_t n = gather_(s, m, lastN, v);
+  if (n == 0) return 0.0f;
+  float sum = 0.0f;
+  for (size_t i = 0; i < n; ++i) sum += v[i];
+  return sum / (float)n;
+}
+
+float MiningSeries::percentile(SeriesScale s, SeriesMetric m, float p,
+                               size_t lastN) const {
+  float v[kSeconds];
+  const size_t n = gather_(s, m, lastN, v);
+  if (n == 0) return 0.0f;
+  // Insertion sort: at most kSeconds entries, reader side only.
+  for (size_t i = 1; i < n; ++i) {
+    const float x = v[i];
+    size_t k = i;
+    while (k > 0 && v[k - 1] > x) {
+      v[k] = v[k - 1];
+      --k;
+    }
+    v[k] = x;
+  }
+  if (p <= 0.0f) return v[0];
+  if (p >= 100.0f) return v[n - 1];
+  size_t rank = (size_t)ceilf(p / 100.0f * (float)n);
+  if (rank < 1) rank = 1;
+  return v[rank - 1];
+}
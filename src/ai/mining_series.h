@@ -0,0 +1,88 @@
+// Module implementation.
+// Fixed-memory time series of mining activity: per-second, per-minute and
+// per-hour buckets of hashes, shares, rejects and ping, plus EWMA / min /
+// max / mean / percentile over them.
+//
+// The miner side only bumps atomic counters (mining_task.cpp); the UI loop
+// turns counter deltas into push() calls once a second. push() is O(1) per
+// second covered and nothing allocates after construction.
+//
+// NOTE:
+// - No Arduino here; single writer (push) and readers on the same task.
+// - Rates: HashRate in H/s, ShareRate / RejectRate per minute, PingMs in ms.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+enum class SeriesScale : uint8_t { Second, Minute, Hour };
+enum class SeriesMetric : uint8_t { HashRate, ShareRate, RejectRate, PingMs };
+
+class MiningSeries {
+public:
+  static constexpr size_t kSeconds = 60;
+  static constexpr size_t kMinutes = 60;
+  static constexpr size_t kHours = 24;
+
+  MiningSeries() = default;
+  MiningSeries(const MiningSeries&) = delete;
+  MiningSeries& operator=(const MiningSeries&) = delete;
+  void reset();
+  // Totals for the last `secs` seconds (spread evenly when secs > 1).
+  // pingMs <= 0: no sample.
+  void push(uint32_t secs, uint32_t hashes, uint32_t shares, uint32_t rejects,
+            float pingMs);
+
+  size_t size(SeriesScale s) const;
+  // Per-second EWMA (time constants in mining_series.cpp); 0 before any push.
+  float ewma(SeriesMetric m) const;
+  // Over the newest lastN buckets of a scale (0 = all held). 0 when empty.
+  float latest(SeriesScale s, SeriesMetric m) const;
+  float minOf(SeriesScale s, SeriesMetric m, size_t lastN = 0) const;
+  float maxOf(SeriesScale s, SeriesMetric m, size_t lastN = 0) const;
+  float mean(SeriesScale s, SeriesMetric m, size_t lastN = 0) const;
+  // Nearest-rank percentile, p in [0, 100].
+  float percentile(SeriesScale s, SeriesMetric m, float p, size_t lastN = 0) const;
+
+private:
+  struct Bucket {
+    uint32_t hashes_ = 0;
+    uint16_t shares_ = 0;
+    uint16_t rejects_ = 0;
+    uint16_t pingMs_ = 0;   // mean of the ping samples (0 = none)
+    uint16_t secs_ = 0;     // seconds covered
+  };
+  // Open bucket of the next coarser scale.
+  struct Acc {
+    uint64_t hashes_ = 0;
+    uint32_t shares_ = 0;
+    uint32_t rejects_ = 0;
+    uint32_t pingSum_ = 0;
+    uint32_t pingN_ = 0;
+    uint32_t secs_ = 0;
+    uint32_t parts_ = 0;    // finer buckets added
+  };
+  struct Ring {
+    Bucket* buf_;
+    size_t cap_;
+    size_t head_ = 0;       // next write
+    size_t count_ = 0;
+  };
+  void pushSecond_(uint32_t hashes, uint32_t shares, uint32_t rejects, float pingMs);
+  static void put_(Ring& r, const Bucket& b);
+  static void add_(Acc& a, const Bucket& b);
+  static Bucket close_(Acc& a);
+  static float value_(const Bucket& b, SeriesMetric m);
+  const Ring& ring_(SeriesScale s) const;
+  size_t gather_(SeriesScale s, SeriesMetric m, size_t lastN, float* out) const;
+
+  Bucket sec_[kSeconds];
+  Bucket min_[kMinutes];
+  Bucket hour_[kHours];
+  Ring rs_{sec_, kSeconds};
+  Ring rm_{min_, kMinutes};
+  Ring rh_{hour_, kHours};
+  Acc accMin_;
+  Acc accHour_;
+  float ewma_[4] = {0, 0, 0, 0};
+  bool primed_ = false;
+};
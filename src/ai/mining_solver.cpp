@@ -0,0 +1,221 @@
+// Module implementation.
+#include "ai/mining_solver.h"
+
+#include <string.h>
+
+#include "ai/duco_sha1.h"
+#if MC_SOLVER_MBEDTLS
+#include <mbedtls/sha1.h>
+#endif
+
+namespace mining_solver {
+namespace {
+// Counts hashes towards the next SolveControl::progress() call.
+struct Checkpoint_ {
+  SolveControl* ctl_;
+  uint32_t every_;
+  uint32_t left_;
+  const volatile uint32_t* poke_;
+  uint32_t pokeSeen_;
+  const uint32_t* hashes_;  // SolveResult::hashes_ of the running solve
+  uint32_t reported_ = 0;   // ... already passed to counted()
+  Checkpoint_(SolveControl* ctl, const uint32_t* hashes)
+      : ctl_(ctl), every_(ctl ? ctl->checkEvery() : UINT32_MAX), left_(every_),
+        poke_(ctl ? ctl->pokeCounter() : nullptr), pokeSeen_(poke_ ? *poke_ : 0),
+        hashes_(hashes) {
+    if (every_ == 0) every_ = left_ = 1;
+  }
+  // Runs on every return path of solve(), so the tail / found hash count too.
+  ~Checkpoint_() { report_(); }
+  void report_() {
+    if (!ctl_ || *hashes_ == reported_) return;
+    ctl_->counted(*hashes_ - reported_);
+    reported_ = *hashes_;
+  }
+  // Returns false when the control asked to abort.
+  bool tick(uint32_t n, uint32_t nonce, const uint32_t h[5]) {
+    const bool poked = poke_ && *poke_ != pokeSeen_;
+    if (left_ > n && !poked) {
+      left_ -= n;
+      return true;
+    }
+    if (poke_) pokeSeen_ = *poke_;
+    report_();
+    if (!ctl_->progress(nonce, h)) return false;
+    every_ = ctl_->checkEvery();
+    if (every_ == 0) every_ = 1;
+    left_ = every_;
+    return true;
+  }
+};
+
+static inline void found_(SolveResult& r, uint32_t nonce, const uint32_t h[5]) {
+  r.status_ = SolveStatus::Found;
+  r.nonce_ = nonce;
+  memcpy(r.h_, h, sizeof(r.h_));
+}
+
+#if MC_SOLVER_MBEDTLS
+static inline void sha1Calc_(const unsigned char* data,
+                             size_t len,
+                             unsigned char out[20]) {
+#if defined(MBEDTLS_VERSION_NUMBER) && (MBEDTLS_VERSION_NUMBER >= 0x03000000)
+  mbedtls_sha1(data, len, out);
+#else
+  mbedtls_sha1_ret(data, len, out);
+#endif
+}
+
+class MbedtlsSolver_ : public MiningSolver {
+public:
+  SolverKind kind() const override { return SolverKind::Mbedtls; }
+  const char* name() const override { return "mbedtls"; }
+  SolveResult solve(const SolveJob& job, SolveControl* ctl) override {
+    SolveResult r;
+    if (job.nonceBegin_ > job.nonceEnd_) return r;
+    char buf[96];
+    size_t seedLen = job.seedLen_;
+    if (seedLen > sizeof(buf) - duco_sha1::kMaxNonceDigits) {
+      seedLen = sizeof(buf) - duco_sha1::kMaxNonceDigits;
+    }
+    memcpy(buf, job.seed_, seedLen);
+    char* noncePtr = buf + seedLen;
+    unsigned char out[20];
+    uint32_t h[5];
+    Checkpoint_ cp(ctl, &r.hashes_);
+    for (uint32_t nonce = job.nonceBegin_;; ++nonce) {
+      const int nlen = duco_sha1::u32ToDec(noncePtr, nonce);
+      sha1Calc_((const unsigned char*)buf, seedLen + nlen, out);
+      duco_sha1::bytesToDigest(out, h);
+      r.hashes_++;
+      if (duco_sha1::matches(h, job.target_)) {
+        found_(r, nonce, h);
+        return r;
+      }
+      if (ctl && !cp.tick(1, nonce, h)) {
+        r.status_ = SolveStatus::Aborted;
+        return r;
+      }
+      if (nonce == job.nonceEnd_) break;
+    }
+    return r;
+  }
+};
+#endif
+
+class MidstateSolver_ : public MiningSolver {
+public:
+  SolverKind kind() const override { return SolverKind::Midstate; }
+  const char* name() const override { return "midstate"; }
+  SolveResult solve(const SolveJob& job, SolveControl* ctl) override {
+    SolveResult r;
+    if (job.nonceBegin_ > job.nonceEnd_) return r;
+    duco_sha1::Midstate mid;
+    if (!duco_sha1::prepare(mid, job.seed_, job.seedLen_)) {
+      r.status_ = SolveStatus::Unsupported;
+      return r;
+    }
+    duco_sha1::NonceCursor cur;
+    cur.reset(mid, job.nonceBegin_);
+    uint32_t h[5];
+    Checkpoint_ cp(ctl, &r.hashes_);
+    for (uint32_t nonce = job.nonceBegin_;; ++nonce) {
+      duco_sha1::hash(mid, cur, h);
+      cur.next();
+      r.hashes_++;
+      if (duco_sha1::matches(h, job.target_)) {
+        found_(r, nonce, h);
+        return r;
+      }
+      if (ctl && !cp.tick(1, nonce, h)) {
+        r.status_ = SolveStatus::Aborted;
+        return r;
+      }
+      if (nonce == job.nonceEnd_) break;
+    }
+    return r;
+  }
+};
+
+template <int N>
+class MultiLaneSolver_ : public MiningSolver {
+public:
+  SolverKind kind() const override { return (SolverKind)((int)SolverKind::MultiLane2 + N - 2); }
+  const char* name() const override { return solverName(kind()); }
+  SolveResult solve(const SolveJob& job, SolveControl* ctl) override {
+    SolveResult r;
+    if (job.nonceBegin_ > job.nonceEnd_) return r;
+    duco_sha1::Midstate mid;
+    if (!duco_sha1::prepare(mid, job.seed_, job.seedLen_)) {
+      r.status_ = SolveStatus::Unsupported;
+      return r;
+    }
+    // Lane k tries nonce + k; every cursor steps by N.
+    duco_sha1::NonceCursor cur[N];
+    for (int l = 0; l < N; ++l) cur[l].reset(mid, job.nonceBegin_ + (uint32_t)l);
+    uint32_t h[N][5];
+    Checkpoint_ cp(ctl, &r.hashes_);
+    for (uint32_t nonce = job.nonceBegin_;; nonce += N) {
+      const uint32_t left = job.nonceEnd_ - nonce;  // nonces after this one
+      if (left < (uint32_t)(N - 1)) {
+        // Short tail: the last nonces run single-lane.
+        for (uint32_t l = 0; l <= left; ++l) {
+          duco_sha1::hash(mid, cur[l], h[0]);
+          r.hashes_++;
+          if (duco_sha1::matches(h[0], job.target_)) {
+            found_(r, nonce + l, h[0]);
+            return r;
+          }
+        }
+        return r;
+      }
+      duco_sha1::hashLanes<N>(mid, cur, h);
+      r.hashes_ += N;
+      for (int l = 0; l < N; ++l) {
+        if (duco_sha1::matches(h[l], job.target_)) {
+          found_(r, nonce + (uint32_t)l, h[l]);
+          return r;
+        }
+      }
+      if (ctl && !cp.tick(N, nonce + N - 1, h[N - 1])) {
+        r.status_ = SolveStatus::Aborted;
+        return r;
+      }
+      if (left == (uint32_t)(N - 1)) break;
+      for (int l = 0; l < N; ++l) cur[l].next((uint8_t)N);
+    }
+    return r;
+  }
+};
+
+#if MC_SOLVER_MBEDTLS
+static MbedtlsSolver_ g_mbedtlsSolver;
+#endif
+static MidstateSolver_ g_midstateSolver;
+static MultiLaneSolver_<3> g_multiLane3Solver;
+static MultiLaneSolver_<4> g_multiLane4Solver;
+} // namespace
+
+MiningSolver* solverFor(SolverKind kind) {
+  switch (kind) {
+#if MC_SOLVER_MBEDTLS
+    case SolverKind::Mbedtls:    return &g_mbedtlsSolver;
+#endif
+    case SolverKind::Midstate:   return &g_midstateSolver;
+    case SolverKind::MultiLane3: return &g_multiLane3Solver;
+    case SolverKind::MultiLane4: return &g_multiLane4Solver;
+    default: return nullptr;
+  }
+}
+
+const char* solverName(SolverKind kind) {
+  switch (kind) {
+    case SolverKind::Mbedtls:    return "mbedtls";
+    case SolverKind::Midstate:   return "midstate";
+    case SolverKind::MultiLane2: return "multilane2";
+    case SolverKind::MultiLane3: return "multilane3";
+    case SolverKind::MultiLane4: return "multilane4";
+    default: return "?";
+  }
+}
+} // namespace mining_solver
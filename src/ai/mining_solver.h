@@ -0,0 +1,79 @@
+// Module implementation.
+// DUCO-S1 solver backends behind one interface.
+//
+// A solver scans a nonce range of one job and reports the matching nonce (if
+// any) and how many hashes it spent. Progress, pause and abort are delegated
+// to a SolveControl supplied by the caller (mining_task.cpp on the device,
+// the benchmark harness on the host).
+//
+// NOTE:
+// - No Arduino / FreeRTOS here, so every backend also builds for env:native.
+// - The mbedTLS backend needs mbedTLS (always present on ESP32). On the host
+//   it is off unless built with -DMC_SOLVER_MBEDTLS=1 -lmbedcrypto.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef MC_SOLVER_MBEDTLS
+  #if defined(ARDUINO)
+    #define MC_SOLVER_MBEDTLS 1 // mining_solver.cpp: mbedTLSバックエンドを組み込む
+  #else
+    #define MC_SOLVER_MBEDTLS 0 // mining_solver.cpp: ホストではリンク指定時のみ有効
+  #endif
+#endif
+
+namespace mining_solver {
+enum class SolverKind : uint8_t {
+  Mbedtls    = 0, // mbedtls_sha1 over seed + decimal nonce (reference)
+  Midstate   = 1, // duco_sha1 midstate + in-place nonce
+  MultiLane2 = 2, // not built: slower than Midstate (solverFor() -> nullptr)
+  MultiLane3 = 3, // duco_sha1::hashLanes<3> (lanes interleaved per round)
+  MultiLane4 = 4, // duco_sha1::hashLanes<4>
+};
+static constexpr uint8_t kSolverKindCount = 5;
+
+struct SolveJob {
+  const char* seed_ = nullptr;   // previous block hash (hex text)
+  size_t   seedLen_ = 0;
+  uint32_t target_[5] = {0};     // expected digest as SHA1 state words
+  uint32_t nonceBegin_ = 0;
+  uint32_t nonceEnd_ = 0;        // inclusive (DUCO: difficulty * 100)
+};
+
+enum class SolveStatus : uint8_t { Found, Exhausted, Aborted, Unsupported };
+
+struct SolveResult {
+  SolveStatus status_ = SolveStatus::Exhausted;
+  uint32_t nonce_ = 0;           // valid when Found
+  uint32_t hashes_ = 0;
+  uint32_t h_[5] = {0};          // digest of nonce_ when Found
+};
+
+class SolveControl {
+public:
+  virtual ~SolveControl() {}
+  // Hashes between progress() calls (re-read after every call).
+  virtual uint32_t checkEvery() const = 0;
+  // Last nonce tried and its digest; return false to abort the job.
+  virtual bool progress(uint32_t nonce, const uint32_t h[5]) = 0;
+  // Optional counter read every hash; a change forces progress() at once
+  // (pause / control changes take effect without waiting for checkEvery()).
+  virtual const volatile uint32_t* pokeCounter() const { return nullptr; }
+  // Optional: hashes done since the previous call; called before every
+  // progress() and once more when the solve returns.
+  virtual void counted(uint32_t hashes) { (void)hashes; }
+};
+
+class MiningSolver {
+public:
+  virtual ~MiningSolver() {}
+  virtual SolverKind kind() const = 0;
+  virtual const char* name() const = 0;
+  // ctl may be nullptr (no progress / abort).
+  virtual SolveResult solve(const SolveJob& job, SolveControl* ctl) = 0;
+};
+
+// Shared stateless instance, or nullptr when the backend is not built.
+MiningSolver* solverFor(SolverKind kind);
+const char* solverName(SolverKind kind);
+} // namespace mining_solver
@@ -5,62 +5,230 @@
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <WiFi.h>
-#include <WiFiClientSecure.h>
-#include <mbedtls/sha1.h>
+
+#include <atomic>
+#include <new>
 
 #include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
 #include "freertos/task.h"
 
+#include "ai/duco_pool_nodes.h"
+#include "ai/duco_protocol.h"
+#include "ai/duco_sha1.h"
+#include "ai/mining_series.h"
+#include "ai/mining_solver.h"
+#include "ai/mining_yield_tuner.h"
 #include "config/config.h"
+#include "config/mc_config_store.h"
+#include "utils/buffered_reader.h"
+#include "utils/https_pool.h"
 #include "utils/logging.h"
 #include "config/runtime_features.h"
 static volatile bool g_miningPaused = false;
+// Pause / resume and thread-count changes are delivered as events: paused
+// workers block on the run bit, idle tasks block on task notifications, and
+// g_miningPoke makes a solve in progress reach its checkpoint on the next hash.
+static EventGroupHandle_t g_miningEvents = nullptr;
+static const EventBits_t  kMiningRunBit  = (1u << 0);
+static volatile uint32_t  g_miningPoke   = 0;
 // Pause flag checked by mining loops to reduce CPU without tearing down connections.
 void setMiningPaused(bool paused) {
   g_miningPaused = paused;
+  if (g_miningEvents) {
+    if (paused) {
+      xEventGroupClearBits(g_miningEvents, kMiningRunBit);
+    } else {
+      xEventGroupSetBits(g_miningEvents, kMiningRunBit);
+    }
+  }
+  g_miningPoke = g_miningPoke + 1;
 }
 bool isMiningPaused() {
   return g_miningPaused;
 }
 static inline void waitWhilePaused_() {
-  // Busy wait with a tiny delay to keep WiFi alive without heavy load.
+  // Block until resumed; no periodic wakeups while paused.
   while (g_miningPaused) {
-    vTaskDelay(pdMS_TO_TICKS(10));
+    xEventGroupWaitBits(g_miningEvents, kMiningRunBit, pdFALSE, pdTRUE,
+                        portMAX_DELAY);
   }
 }
-static const uint8_t kDucoMinerThreads = 2;
-static const char*   kDucoPoolUrl      = "https://server.duinocoin.com/getPool";
+// Miner task count / affinity / priority / stack come from mc_config_store
+// (miner_*) and are fixed at startMiner(); arrays are sized for the maximum.
+static const uint8_t kDucoMaxMinerThreads = MC_DUCO_MAX_THREADS;
+// One spare connection so a prefetched job is always queued while every
+// worker is hashing (the pool protocol is lockstep per connection:
+// JOB -> result -> JOB).
+static const uint8_t kDucoMaxConnections  = kDucoMaxMinerThreads + 1;
+static uint8_t g_minerThreads = 0;   // set once by startMiner()
+static uint8_t g_connections  = 0;   // g_minerThreads + 1
+static const char*   kDucoPoolUrl      = MC_DUCO_POOL_URL;
+// Dead-node detection: a node that cannot connect / greet within these is
+// benched and the next-ranked node is tried at once.
+static const int32_t  kDucoConnectTimeoutMs = 700;
+static const uint32_t kDucoBannerTimeoutMs  = 2000;
+// A started line must complete within this (matches the socket timeout).
+static const uint32_t kDucoLineTimeoutMs    = 15000;
+// Work snapshot shown in the ticker.
+struct DucoWork {
+  bool     valid_    = false;
+  uint32_t nonce_    = 0;
+  uint32_t maxNonce_ = 0;
+  uint32_t diff_     = 0;
+  uint8_t  out_[20]  = {0};
+  char     seed_[41] = {0};
+};
+// Per solver worker (DucoMiner<i>).
 struct DucoThreadStats {
-  bool     connected_    = false;
-  float    hashrateKh_  = 0.0f;
-  uint32_t shares_       = 0;
-  uint32_t difficulty_   = 0;
-  uint32_t accepted_     = 0;
-  uint32_t rejected_     = 0;
-  float    lastPingMs_ = 0.0f;
-  bool     workValid_      = false;
-  uint32_t workNonce_      = 0;
-  uint32_t workMaxNonce_  = 0;
-  uint32_t workDiff_       = 0;
-  uint8_t  workOut_[20]    = {0};
-  char     workSeed_[41]   = {0};
+  std::atomic<float>    hashrateKh_{0.0f};
+  std::atomic<bool>     busy_{false};    // holding a job
+  std::atomic<uint32_t> busyUs_{0};      // hashing time (wraps), for duty cycle
+  std::atomic<uint32_t> hashes_{0};      // hashes done (wraps), for g_series
+  std::atomic<int8_t>   core_{-1};       // core of the last checkpoint
+  // work_ has one writer (the owning worker) and is published through a
+  // sequence lock: the miner never waits, readers retry on a torn copy.
+  std::atomic<uint32_t> workSeq_{0};     // odd while a write is in progress
+  DucoWork work_;
+  void reset() {
+    hashrateKh_.store(0.0f);
+    busy_.store(false);
+    busyUs_.store(0);
+    hashes_.store(0);
+    core_.store(-1);
+    workSeq_.store(0);
+    work_ = DucoWork();
+  }
+};
+// Per pool connection (DucoNet<i>). Written by its net task, read by the UI.
+struct DucoConnStats {
+  std::atomic<bool>     connected_{false};
+  std::atomic<uint32_t> shares_{0};
+  std::atomic<uint32_t> difficulty_{0};
+  std::atomic<uint32_t> accepted_{0};
+  std::atomic<uint32_t> rejected_{0};
+  std::atomic<float>    lastPingMs_{0.0f};
+  void reset() {
+    connected_.store(false);
+    shares_.store(0);
+    difficulty_.store(0);
+    accepted_.store(0);
+    rejected_.store(0);
+    lastPingMs_.store(0.0f);
+  }
+};
+static inline void workWriteBegin_(DucoThreadStats& st) {
+  st.workSeq_.store(st.workSeq_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+static inline void workWriteEnd_(DucoThreadStats& st) {
+  st.workSeq_.store(st.workSeq_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+}
+// Consistent copy of st.work_; false if the writer kept it busy (rare).
+static bool workRead_(const DucoThreadStats& st, DucoWork& out) {
+  for (int tries = 0; tries < 8; ++tries) {
+    const uint32_t s0 = st.workSeq_.load(std::memory_order_acquire);
+    if (s0 & 1u) continue;
+    memcpy(&out, &st.work_, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (st.workSeq_.load(std::memory_order_relaxed) == s0) return true;
+  }
+  return false;
+}
+// Net task -> workers. connGen_ ties the job to one socket session; a job
+// whose connection has since dropped is skipped (or cancelled mid-solve).
+struct DucoJobMsg {
+  uint8_t  conn_       = 0;
+  uint32_t connGen_    = 0;
+  uint32_t difficulty_ = 0;
+  uint32_t target_[5]  = {0};
+  char     seed_[64]   = {0};
+  uint8_t  seedLen_    = 0;
+  // Resume state of a job handed back after an abort (0 = fresh job).
+  uint32_t resumeNonce_ = 0;  // first nonce still to try
+  uint32_t doneHashes_  = 0;  // hashes / time spent before, for the reported H/s
+  uint32_t doneUs_      = 0;
+};
+// Worker -> net task of job.conn_.
+struct DucoResultMsg {
+  uint32_t connGen_ = 0;
+  uint32_t nonce_   = UINT32_MAX;  // UINT32_MAX: none, kDucoAborted: aborted
+  uint32_t hashes_  = 0;
+  float    hps_     = 0.0f;
+  uint32_t resumeNonce_ = 0;       // kDucoAborted: where to pick the job up
+  uint32_t us_      = 0;           // kDucoAborted: time spent on this attempt
+};
+// Every aborted job, by seed + target: if its session then goes away (even
+// after the requeue), a job the pool hands out again soon after is resumed
+// instead of rescanned.
+struct DucoResumeSlot {
+  uint32_t savedMs_    = 0;      // 0 = empty
+  uint32_t target_[5]  = {0};
+  uint32_t difficulty_ = 0;
+  uint32_t nextNonce_  = 0;
+  char     seed_[64]   = {0};
 };
-static DucoThreadStats   g_thr[kDucoMinerThreads];
+static const uint8_t  kDucoResumeSlots = 4;
+static const uint32_t kDucoResumeTtlMs = 60000;
+static DucoResumeSlot g_resume[kDucoResumeSlots];
+static portMUX_TYPE   g_resumeMux = portMUX_INITIALIZER_UNLOCKED;
+// Saved vs taken-up slots (logged on each hit, to see whether the pool
+// actually reissues jobs often enough for the slots to pay off).
+static std::atomic<uint32_t> g_resumeSaves{0}, g_resumeHits{0};
+static DucoThreadStats*  g_thr = nullptr;  // g_minerThreads entries
+static DucoConnStats     g_conn[kDucoMaxConnections];
+static TaskHandle_t      g_minerTask[kDucoMaxMinerThreads] = {nullptr};
+static TaskHandle_t      g_netTask[kDucoMaxConnections] = {nullptr};
+static QueueHandle_t     g_jobQ = nullptr;
+static QueueHandle_t     g_resultQ[kDucoMaxConnections] = {nullptr};
+static volatile uint32_t g_connGen[kDucoMaxConnections] = {0};
+// Per-connection receive buffers (kept off the net task stacks).
+static BufferedReader    g_rx[kDucoMaxConnections];
+// Hashes done on each core (wraps); the per-core hashrate of the topology
+// measurement comes from these.
+static std::atomic<uint32_t> g_coreHashes[portNUM_PROCESSORS];
+// Cooperative mode (MC_DUCO_COOP): T0 takes each job from the queue and shares
+// it with the other miner tasks; everyone steals fixed nonce blocks until the
+// first hit or the end of the range.
+static const uint32_t kDucoCoopBlock = 8192;
+struct DucoCoopJob {
+  std::atomic<uint32_t> state_{0};        // (epoch << 1) | open
+  std::atomic<uint32_t> active_{0};       // helpers inside the current epoch
+  std::atomic<uint32_t> nextBlock_{0};
+  std::atomic<uint32_t> helperHashes_{0};
+  std::atomic<bool>     found_{false};
+  uint32_t foundNonce_ = 0;               // valid after found_ (written once)
+  uint32_t foundH_[5]  = {0};
+  DucoJobMsg msg_;
+  mining_solver::SolveJob job_;
+};
+static DucoCoopJob g_coop;
 static SemaphoreHandle_t g_shaMutex = nullptr;
-static portMUX_TYPE g_statsMux = portMUX_INITIALIZER_UNLOCKED;
 static String   g_nodeName;
-static String   g_host;
-static uint16_t g_port = 0;
-static uint32_t g_accAll = 0, g_rejAll = 0;
+static TaskHandle_t g_poolRefreshTask = nullptr;
+static std::atomic<uint32_t> g_accAll{0}, g_rejAll{0};
+// Activity history; fed once a second from the counters above by
+// updateMiningSummary() (UI loop), never touched by the miner tasks.
+static MiningSeries g_series;
 static String   g_status = "boot";
 static bool     g_anyConnected = false;
 static char     g_chipId[16] = {0};
 static int      g_walletId = 0;
 static String   g_poolDiagText = "";
 // ===== mining control knobs (for attention mode etc.) =====
-static volatile uint8_t  g_miningActiveThreads = kDucoMinerThreads; // 0..kDucoMinerThreads
+static volatile uint8_t  g_miningActiveThreads = kDucoMaxMinerThreads; // 0..g_minerThreads
 static volatile uint16_t g_yieldEvery = 1024;   // power-of-two recommended
 static volatile uint8_t  g_yieldMs    = 1;      // delay in ms at yield points
+// g_yieldEvery / g_yieldMs are what the workers use: the requested profile,
+// or the autotuner's choice while the request is MiningYieldNormal().
+static MiningYieldProfile g_yieldReq = MiningYieldNormal();
+static MiningYieldTuner   g_yieldTuner;
+static bool               g_yieldTunerReady = false;
+static MiningYieldProfile g_yieldLimit(0, 0);     // every_ = 0: no limit
+static MiningGovernorState g_govState;
 static inline uint16_t normalizePow2_(uint16_t v) {
   // Force to power-of-two for a cheap bitmask in the nonce loop.
   if (v < 8) v = 8;
@@ -72,15 +240,24 @@ static inline uint16_t normalizePow2_(uint16_t v) {
 static const uint32_t kDucoAborted = UINT32_MAX - 1;
 // === src/mining_task.cpp : replace whole function ===
 static bool ducoGetPool_() {
-  WiFiClientSecure s;
-  s.setInsecure();
-  HTTPClient http;
+  // Plain http:// is only used for tools/duco_pool_emu.py on the LAN.
+  const bool tls = strncmp(kDucoPoolUrl, "http://", 7) != 0;
+  https_pool::Lease lease;
+  WiFiClient plain;
+  HTTPClient plainHttp;
+  if (tls && !lease.acquire(kDucoPoolUrl)) {
+    g_poolDiagText = "Cannot connect to the pool info server.";
+    return false;
+  }
+  HTTPClient& http = tls ? lease.http() : plainHttp;
   http.setTimeout(7000);
-  if (!http.begin(s, kDucoPoolUrl)) {
+  http.setReuse(tls);
+  if (!http.begin(tls ? (WiFiClient&)lease.client() : plain, kDucoPoolUrl)) {
     g_poolDiagText = "Cannot connect to the pool info server.";
     return false;
   }
   int code = http.GET();
+  if (tls && lease.retryFresh(code, true)) code = http.GET();
   if (code != HTTP_CODE_OK) {
     http.end();
     g_poolDiagText = "Pool info server responded with an error.";
@@ -93,318 +270,647 @@ static bool ducoGetPool_() {
     g_poolDiagText = "Failed to parse pool info response.";
     return false;
   }
-  g_nodeName = doc["name"].as<String>();
-  g_host      = doc["ip"].as<String>();
-  g_port      = (uint16_t)doc["port"].as<int>();
-  MC_EVT("DUCO", "Pool: %s (%s:%u)",
-         g_nodeName.c_str(),
-         g_host.c_str(), (unsigned)g_port);
-  if (g_port != 0 && g_host.length()) {
+  const char* name = doc["name"] | "";
+  const char* ip   = doc["ip"] | "";
+  const uint16_t port = (uint16_t)(doc["port"] | 0);
+  MC_EVT("DUCO", "Pool: %s (%s:%u)", name, ip, (unsigned)port);
+  if (port != 0 && ip[0]) {
+    duco_pool_nodes::addFromPool(name, ip, port);
     g_poolDiagText = "";
     return true;
   }
   g_poolDiagText = "Pool info response is incomplete.";
   return false;
 }
-static inline int u32ToDec_(char* dst, uint32_t v) {
-  if (v == 0) {
-    dst[0] = '0';
-    return 1;
-  }
-  char tmp[10];
-  int n = 0;
-  while (v) {
-    tmp[n++] = char('0' + (v % 10));
-    v /= 10;
-  }
-  for (int i = 0; i < n; ++i) {
-    dst[i] = tmp[n - 1 - i];
-  }
-  return n;
-}
-// ---------- SHA1 helper (mbedTLS) ----------
-static inline void sha1Calc_(const unsigned char* data,
-                             size_t len,
-                             unsigned char out[20]) {
-#if defined(MBEDTLS_VERSION_NUMBER) && (MBEDTLS_VERSION_NUMBER >= 0x03000000)
-  mbedtls_sha1(data, len, out);
-#else
-  mbedtls_sha1_ret(data, len, out);
-#endif
-}
-static uint32_t ducoSolveDucoS1_(const String& seed,
-                                  const unsigned char* expected20,
-                                  uint32_t difficulty,
-                                    uint32_t& hashesDone,
-                                  DucoThreadStats* stats) {
-  // Tight loop: compute SHA1(seed + nonce) until the hash matches expected20.
-  const uint32_t maxNonce = difficulty * 100U;
-  hashesDone = 0;
-  char buf[96];
-  int seedLen = seed.length();
-  if (seedLen > (int)sizeof(buf) - 12) seedLen = sizeof(buf) - 12;
-  memcpy(buf, seed.c_str(), seedLen);
-  char* noncePtr = buf + seedLen;
-  unsigned char out[20];
-// thread index (0/1..) for control checks
-const int tIdx = (stats) ? int(stats - g_thr) : -1;
-if (tIdx >= 0 && tIdx >= (int)g_miningActiveThreads) {
-  return kDucoAborted;
-}
-  for (uint32_t nonce = 0; nonce <= maxNonce; ++nonce) {
+// Keeps the node list filled from getPool (each answer may name a different
+// node): right away when the warm start used cached nodes, then periodically,
+// more often while there are few candidates.
+static void ducoPoolRefreshTask_(void* pv) {
+  bool haveCache = pv != nullptr;
+  for (;;) {
+    if (!haveCache) vTaskDelay(pdMS_TO_TICKS(60000));  // net tasks fetch first
+    haveCache = false;
+    while (WiFi.status() != WL_CONNECTED) vTaskDelay(pdMS_TO_TICKS(500));
+    ducoGetPool_();
+    const bool few = duco_pool_nodes::count() < 3;
+    vTaskDelay(pdMS_TO_TICKS(few ? 60000 : 15UL * 60UL * 1000UL));
+  }
+}
+// Progress hook for the solver backends: publishes the work snapshot,
+// honours pause / thread disable, yields per the yield profile and keeps
+// the worker's hashing time for the duty-cycle metric.
+class DucoSolveControl : public mining_solver::SolveControl {
+public:
+  DucoSolveControl(DucoThreadStats* stats, uint32_t maxNonce,
+                   const DucoJobMsg* job = nullptr,
+                   const DucoCoopJob* coop = nullptr, uint32_t epoch = 0)
+      : stats_(stats),
+        tIdx_(stats ? int(stats - g_thr) : -1),
+        maxNonce_(maxNonce),
+        job_(job),
+        coop_(coop),
+        epoch_(epoch),
+        markUs_(micros()) {}
+  bool disabled() const {
+    return tIdx_ >= 0 && tIdx_ >= (int)g_miningActiveThreads;
+  }
+  // Connection behind the job dropped, or the cooperative job was closed or
+  // already solved by another worker.
+  bool cancelled() const {
+    if (job_ && g_connGen[job_->conn_] != job_->connGen_) return true;
+    return coop_ && (coop_->found_.load() || coop_->state_.load() != epoch_);
+  }
+  uint32_t checkEvery() const override { return g_yieldEvery; }
+  const volatile uint32_t* pokeCounter() const override { return &g_miningPoke; }
+  void counted(uint32_t hashes) override {
+    const int core = (int)xPortGetCoreID();
+    g_coreHashes[core].fetch_add(hashes, std::memory_order_relaxed);
+    if (!stats_) return;
+    stats_->hashes_.fetch_add(hashes, std::memory_order_relaxed);
+    stats_->core_.store((int8_t)core, std::memory_order_relaxed);
+  }
+  bool progress(uint32_t nonce, const uint32_t h[5]) override {
+    lastNonce_ = nonce;
+    tried_ = true;
+    account();
     // When paused, we yield here and resume from the same nonce (no disconnect / no job drop).
     if (g_miningPaused) {
       waitWhilePaused_();
-      // If this thread got disabled while paused, abort cleanly.
-        if (tIdx >= 0 && tIdx >= (int)g_miningActiveThreads) {
-        return kDucoAborted;
-      }
     }
-     int nlen = u32ToDec_(noncePtr, nonce);
-     sha1Calc_((const unsigned char*)buf, seedLen + nlen, out);
-     hashesDone++;
-    if (memcmp(out, expected20, 20) == 0) {
+    publish(nonce, h);
+    // If this thread got disabled mid-job, abort cleanly.
+    if (disabled() || cancelled()) return false;
+    uint8_t dms = g_yieldMs;
+    if (dms) vTaskDelay(pdMS_TO_TICKS(dms));
+    markUs_ = micros();
+    return true;
+  }
+  void publish(uint32_t nonce, const uint32_t h[5]) {
+    if (!stats_) return;
+    uint8_t out[20];
+    duco_sha1::digestToBytes(h, out);
+    workWriteBegin_(*stats_);
+    stats_->work_.nonce_    = nonce;
+    stats_->work_.maxNonce_ = maxNonce_;
+    memcpy(stats_->work_.out_, out, 20);
+    stats_->work_.valid_ = true;
+    workWriteEnd_(*stats_);
+  }
+  // Add hashing time since the last mark (call once more when the solve ends).
+  void account() {
+    const uint32_t now = micros();
+    if (stats_) stats_->busyUs_.fetch_add(now - markUs_, std::memory_order_relaxed);
+    markUs_ = now;
+  }
+  // First nonce not tried yet when the solve was aborted (solver reports
+  // every batch it finished through progress()).
+  uint32_t resumeFrom(uint32_t begin) const { return tried_ ? lastNonce_ + 1 : begin; }
+private:
+  DucoThreadStats* stats_;
+  int tIdx_;
+  uint32_t maxNonce_;
+  const DucoJobMsg* job_;
+  const DucoCoopJob* coop_;
+  uint32_t epoch_;
+  uint32_t markUs_;
+  uint32_t lastNonce_ = 0;
+  bool tried_ = false;
+};
+// Configured backend; the reference path takes seeds the midstate layout can't.
+static mining_solver::SolveResult ducoSolveRange_(const mining_solver::SolveJob& job,
+                                                  DucoSolveControl* ctl) {
+  mining_solver::MiningSolver* solver =
+      mining_solver::solverFor((mining_solver::SolverKind)MC_DUCO_SOLVER);
+  if (!solver) solver = mining_solver::solverFor(mining_solver::SolverKind::Midstate);
+  mining_solver::SolveResult r = solver->solve(job, ctl);
+  if (r.status_ == mining_solver::SolveStatus::Unsupported) {
+    mining_solver::MiningSolver* ref =
+        mining_solver::solverFor(mining_solver::SolverKind::Mbedtls);
+    if (ref) r = ref->solve(job, ctl);
+  }
+  return r;
+}
+static mining_solver::SolveJob ducoSolveJob_(const DucoJobMsg& msg) {
+  mining_solver::SolveJob job;
+  job.seed_ = msg.seed_;
+  job.seedLen_ = msg.seedLen_;
+  memcpy(job.target_, msg.target_, sizeof(job.target_));
+  job.nonceBegin_ = msg.resumeNonce_;
+  job.nonceEnd_ = msg.difficulty_ * 100U;
+  return job;
+}
+static bool ducoResumeMatch_(const DucoResumeSlot& r, const DucoJobMsg& msg) {
+  return r.savedMs_ && r.difficulty_ == msg.difficulty_ &&
+         memcmp(r.target_, msg.target_, sizeof(r.target_)) == 0 &&
+         strcmp(r.seed_, msg.seed_) == 0;
+}
+static void ducoResumeSave_(const DucoJobMsg& msg, uint32_t nextNonce) {
+  const uint32_t now = millis();
+  portENTER_CRITICAL(&g_resumeMux);
+  int slot = 0;
+  for (int i = 0; i < kDucoResumeSlots; ++i) {
+    if (ducoResumeMatch_(g_resume[i], msg)) {
+      slot = i;
+      break;
+    }
+    // Otherwise the oldest (or an empty) slot.
+    if (g_resume[i].savedMs_ == 0 ||
+        (int32_t)(g_resume[i].savedMs_ - g_resume[slot].savedMs_) < 0) {
+      slot = i;
+    }
+  }
+  DucoResumeSlot& r = g_resume[slot];
+  r.savedMs_ = now ? now : 1;
+  memcpy(r.target_, msg.target_, sizeof(r.target_));
+  r.difficulty_ = msg.difficulty_;
+  r.nextNonce_ = nextNonce;
+  memcpy(r.seed_, msg.seed_, sizeof(r.seed_));
+  portEXIT_CRITICAL(&g_resumeMux);
+  ++g_resumeSaves;
+}
+// Next nonce of a remembered copy of this job (and forget it), or 0.
+static uint32_t ducoResumeTake_(const DucoJobMsg& msg) {
+  const uint32_t now = millis();
+  uint32_t next = 0;
+  portENTER_CRITICAL(&g_resumeMux);
+  for (int i = 0; i < kDucoResumeSlots; ++i) {
+    DucoResumeSlot& r = g_resume[i];
+    if (r.savedMs_ && now - r.savedMs_ > kDucoResumeTtlMs) r.savedMs_ = 0;
+    if (ducoResumeMatch_(r, msg)) {
+      next = r.nextNonce_;
+      r.savedMs_ = 0;
+    }
+  }
+  portEXIT_CRITICAL(&g_resumeMux);
+  return next;
+}
+static uint32_t ducoSolveDucoS1_(const DucoJobMsg& msg,
+                                  uint32_t& hashesDone,
+                                  uint32_t& resumeNonce,
+                                  DucoThreadStats* stats) {
+  // Scan 0..difficulty*100 with the configured backend until the digest
+  // matches the target.
+  // A job handed back after an abort (or seen again on a new session)
+  // continues where it stopped.
+  mining_solver::SolveJob job = ducoSolveJob_(msg);
+  // Always take the slot, so a requeued job does not leave a stale copy.
+  const uint32_t saved = ducoResumeTake_(msg);
+  if (saved > job.nonceBegin_) {
+    if (msg.resumeNonce_ == 0) {
+      const uint32_t hits = ++g_resumeHits;
+      MC_EVT("DUCO", "resume hit: diff=%u from nonce %u (hits=%u saves=%u)",
+             (unsigned)msg.difficulty_, (unsigned)saved, (unsigned)hits,
+             (unsigned)g_resumeSaves.load());
+    }
+    job.nonceBegin_ = saved;
+  }
+  hashesDone = 0;
+  resumeNonce = job.nonceBegin_;
+  DucoSolveControl ctl(stats, job.nonceEnd_, &msg);
+  if (ctl.disabled()) {
+    return kDucoAborted;
+  }
+  if (job.nonceBegin_ > job.nonceEnd_) return UINT32_MAX;
+  mining_solver::SolveResult r = ducoSolveRange_(job, &ctl);
+  ctl.account();
+  hashesDone = r.hashes_;
+  switch (r.status_) {
+    case mining_solver::SolveStatus::Found:
       // Found a valid share; publish progress atomically.
-      if (stats) {
-        portENTER_CRITICAL(&g_statsMux);
-        stats->workNonce_     = nonce;
-        stats->workMaxNonce_ = maxNonce;
-        memcpy(stats->workOut_, out, 20);
-        stats->workValid_ = true;
-        portEXIT_CRITICAL(&g_statsMux);
+      ctl.publish(r.nonce_, r.h_);
+      return r.nonce_;
+    case mining_solver::SolveStatus::Aborted:
+      resumeNonce = ctl.resumeFrom(job.nonceBegin_);
+      // Remembered on every abort: a requeued job is lost too when its
+      // session drops before another worker picks it up.
+      ducoResumeSave_(msg, resumeNonce);
+      return kDucoAborted;
+    default:
+      return UINT32_MAX;
+  }
+}
+// Steal blocks of the open cooperative job until it is solved, closed or
+// exhausted. Returns Aborted only when this thread got disabled.
+static mining_solver::SolveStatus ducoCoopWork_(uint32_t epoch,
+                                                DucoThreadStats* stats,
+                                                uint32_t& hashes) {
+  hashes = 0;
+  const uint32_t end = g_coop.job_.nonceEnd_;
+  DucoSolveControl ctl(stats, end, &g_coop.msg_, &g_coop, epoch);
+  for (;;) {
+    if (ctl.disabled()) return mining_solver::SolveStatus::Aborted;
+    if (ctl.cancelled()) return mining_solver::SolveStatus::Exhausted;
+    const uint64_t begin = (uint64_t)g_coop.nextBlock_.fetch_add(1) * kDucoCoopBlock;
+    if (begin > end) return mining_solver::SolveStatus::Exhausted;
+    mining_solver::SolveJob part = g_coop.job_;
+    part.nonceBegin_ = (uint32_t)begin;
+    part.nonceEnd_ = (begin + kDucoCoopBlock - 1 < end)
+                         ? (uint32_t)(begin + kDucoCoopBlock - 1) : end;
+    const mining_solver::SolveResult r = ducoSolveRange_(part, &ctl);
+    ctl.account();
+    hashes += r.hashes_;
+    if (r.status_ == mining_solver::SolveStatus::Found) {
+      // First hit wins; the others see found_ at their next checkpoint.
+      bool expected = false;
+      if (g_coop.found_.compare_exchange_strong(expected, true)) {
+        g_coop.foundNonce_ = r.nonce_;
+        memcpy(g_coop.foundH_, r.h_, sizeof(g_coop.foundH_));
+        ctl.publish(r.nonce_, r.h_);
       }
-      return nonce;
+      return mining_solver::SolveStatus::Found;
     }
-    uint16_t every = g_yieldEvery;
-    uint32_t mask  = (every >= 1) ? (uint32_t)(every - 1) : 0xFFFFFFFFu;
-    if ((nonce & mask) == 0) {
-      // Periodic progress update and cooperative yield.
-      if (stats) {
-        portENTER_CRITICAL(&g_statsMux);
-        stats->workNonce_     = nonce;
-        stats->workMaxNonce_ = maxNonce;
-        memcpy(stats->workOut_, out, 20);
-        stats->workValid_ = true;
-        portEXIT_CRITICAL(&g_statsMux);
-      }
-      // If this thread got disabled mid-job, abort cleanly.
-        if (tIdx >= 0 && tIdx >= (int)g_miningActiveThreads) {
-        return kDucoAborted;
-      }
-      uint8_t dms = g_yieldMs;
-      if (dms) vTaskDelay(pdMS_TO_TICKS(dms));
+    if (r.status_ == mining_solver::SolveStatus::Aborted) {
+      return ctl.disabled() ? mining_solver::SolveStatus::Aborted
+                            : mining_solver::SolveStatus::Exhausted;
+    }
+  }
+}
+// Leader side (T0): open the job for the helpers, work on it, then close it
+// and wait until every helper has left before the job buffer is reused.
+static uint32_t ducoSolveCoop_(const DucoJobMsg& msg,
+                               uint32_t& hashesDone,
+                               DucoThreadStats* stats) {
+  hashesDone = 0;
+  DucoSolveControl self(stats, msg.difficulty_ * 100U, &msg);
+  if (self.disabled()) {
+    return kDucoAborted;
+  }
+  g_coop.msg_ = msg;
+  g_coop.job_ = ducoSolveJob_(g_coop.msg_);
+  g_coop.nextBlock_.store(0);
+  g_coop.helperHashes_.store(0);
+  g_coop.found_.store(false);
+  const uint32_t epoch = (((g_coop.state_.load() >> 1) + 1) << 1) | 1u;
+  g_coop.state_.store(epoch);
+  for (int i = 1; i < g_minerThreads; ++i) {
+    if (g_minerTask[i]) xTaskNotifyGive(g_minerTask[i]);
+  }
+  uint32_t own = 0;
+  const mining_solver::SolveStatus st = ducoCoopWork_(epoch, stats, own);
+  g_coop.state_.store(epoch & ~1u);
+  while (g_coop.active_.load() > 0) {
+    vTaskDelay(pdMS_TO_TICKS(1));
+  }
+  hashesDone = own + g_coop.helperHashes_.load();
+  if (g_coop.found_.load()) {
+    self.publish(g_coop.foundNonce_, g_coop.foundH_);
+    return g_coop.foundNonce_;
+  }
+  return (st == mining_solver::SolveStatus::Aborted) ? kDucoAborted : UINT32_MAX;
+}
+// Helper side (T1..): never takes jobs from the queue, just joins whatever
+// job T0 opens.
+static void ducoCoopHelper_(int idx, DucoThreadStats& me) {
+  me.hashrateKh_ = 0.0f;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (idx >= (int)g_miningActiveThreads) continue;
+    const uint32_t s = g_coop.state_.load();
+    if (!(s & 1u)) continue;
+    g_coop.active_.fetch_add(1);
+    // Re-check after registering: the leader only reuses the buffer once
+    // active_ drops to zero, so a matching epoch here means the job is stable.
+    if (g_coop.state_.load() == s) {
+      workWriteBegin_(me);
+      me.work_.diff_ = g_coop.msg_.difficulty_;
+      me.work_.valid_ = false;
+      strncpy(me.work_.seed_, g_coop.msg_.seed_, 40);
+      me.work_.seed_[40] = '\0';
+      workWriteEnd_(me);
+      me.busy_ = true;
+      uint32_t hashes = 0;
+      ducoCoopWork_(s, &me, hashes);
+      me.busy_ = false;
+      g_coop.helperHashes_.fetch_add(hashes);
+    }
+    g_coop.active_.fetch_sub(1);
+  }
+}
+// Connections wanted for the current thread setting: one per job consumer
+// plus one so the next job is already queued when a worker finishes.
+static int ducoWantedConns_() {
+  const int active = (int)g_miningActiveThreads;
+  if (active <= 0) return 0;
+  const int consumers = MC_DUCO_COOP ? 1 : active;
+  return consumers + 1;
+}
+// One pool line into a fixed buffer (NUL-terminated, CR / LF dropped).
+// Empty on timeout, close or an overlong line.
+static size_t ducoReadLine_(BufferedReader& rx, char* buf, size_t cap) {
+  const int n = rx.readLine(buf, cap, kDucoLineTimeoutMs);
+  if (n < 0) {
+    buf[0] = '\0';
+    return 0;
+  }
+  return (size_t)n;
+}
+// Wait for this connection's result. Aborted results (worker disabled
+// mid-job) put the job back in front of the queue for another worker.
+// Control changes post a wake message (connGen_ 0), so the timeout is only
+// for noticing a dead socket.
+static bool ducoWaitResult_(int ci, WiFiClient& cli, DucoJobMsg& job,
+                            DucoResultMsg& res) {
+  for (;;) {
+    if (xQueueReceive(g_resultQ[ci], &res, pdMS_TO_TICKS(1000)) == pdTRUE &&
+        res.connGen_ == job.connGen_) {
+      if (res.nonce_ != kDucoAborted) return true;
+      // Hand it back to the pool of workers from where it stopped.
+      job.resumeNonce_ = res.resumeNonce_;
+      job.doneHashes_ += res.hashes_;
+      job.doneUs_ += res.us_;
+      xQueueSendToFront(g_jobQ, &job, 0);
+    }
+    if (ci >= ducoWantedConns_() || !cli.connected()) return false;
+  }
+}
+// Wake every idle miner / net task so it re-reads the control knobs.
+static void ducoWakeAll_() {
+  for (int i = 0; i < g_minerThreads; ++i) {
+    if (g_minerTask[i]) xTaskNotifyGive(g_minerTask[i]);
+  }
+  for (int i = 0; i < g_connections; ++i) {
+    if (g_netTask[i]) xTaskNotifyGive(g_netTask[i]);
+    if (g_resultQ[i]) {
+      DucoResultMsg wake;
+      wake.connGen_ = 0;  // never a live session
+      xQueueSend(g_resultQ[i], &wake, 0);
     }
   }
-  return UINT32_MAX;
 }
 // === src/mining_task.cpp : replace whole function ===
-static void ducoTask_(void* pv) {
-  int idx = (int)(intptr_t)pv;
-  if (idx < 0 || idx >= kDucoMinerThreads) idx = 0;
-  auto& me = g_thr[idx];
+// Pool connection task: JOB request/parse, hand-off to the workers, submit
+// and feedback. Never hashes, so its round trips overlap other jobs' solves.
+static void ducoNetTask_(void* pv) {
+  int ci = (int)(intptr_t)pv;
+  if (ci < 0 || ci >= g_connections) ci = 0;
+  auto& cs = g_conn[ci];
   char tag[8];
-  snprintf(tag, sizeof(tag), "T%d", idx);
-  MC_LOGI("DUCO", "miner task start %s", tag);
+  snprintf(tag, sizeof(tag), "C%d", ci);
+  MC_LOGI("DUCO", "net task start %s", tag);
   const auto& cfg = appConfig();
   for (;;) {
-    // ----- mining control: idle if this thread is disabled (STOP/HALF) -----
-    if (idx >= (int)g_miningActiveThreads) {
-      me.connected_   = false;
-      me.hashrateKh_ = 0.0f;
-      vTaskDelay(pdMS_TO_TICKS(200));
+    // ----- mining control: idle if this connection is not needed (STOP/HALF) -----
+    if (ci >= ducoWantedConns_()) {
+      cs.connected_ = false;
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
       continue;
     }
     // WiFi
     while (WiFi.status() != WL_CONNECTED) {
       // disabled while waiting for WiFi -> just idle
-      if (idx >= (int)g_miningActiveThreads) {
-        me.connected_   = false;
-        me.hashrateKh_ = 0.0f;
-        vTaskDelay(pdMS_TO_TICKS(200));
+      if (ci >= ducoWantedConns_()) {
+        cs.connected_ = false;
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
         continue;
       }
-      me.connected_ = false;
+      cs.connected_ = false;
       g_status = "WiFi connecting...";
       g_poolDiagText = "Waiting for WiFi connection.";
       vTaskDelay(pdMS_TO_TICKS(1000));
     }
-    // Pool discovery / reconnect
-    if (g_port == 0) {
-      if (!ducoGetPool_()) {
+    // Best-ranked usable node for this slot; getPool only when none is left.
+    // A failed node is benched, so the next pass goes straight to another one.
+    duco_pool_nodes::Node node;
+    if (!duco_pool_nodes::pick((uint8_t)ci, node)) {
+      if (!ducoGetPool_() || !duco_pool_nodes::pick((uint8_t)ci, node)) {
         vTaskDelay(pdMS_TO_TICKS(5000));
         continue;
       }
     }
     WiFiClient cli;
     cli.setTimeout(15);
+    BufferedReader& rx = g_rx[ci];
+    rx.attach(&cli);
     MC_LOGI_RL("duco_connect", 10000, "DUCO",
-               "%s connect %s:%u ...",
-               tag, g_host.c_str(), g_port);
-    if (!cli.connect(g_host.c_str(), g_port)) {
-      me.connected_ = false;
+               "%s connect %s %s:%u (score %.0f) ...",
+               tag, node.name_, node.ip_, (unsigned)node.port_,
+               duco_pool_nodes::score(node));
+    if (!cli.connect(node.ip_, node.port_, kDucoConnectTimeoutMs)) {
+      cs.connected_ = false;
+      duco_pool_nodes::reportConnect(node, false);
       g_poolDiagText = "Cannot connect to the pool node.";
-      vTaskDelay(pdMS_TO_TICKS(1000));
+      vTaskDelay(pdMS_TO_TICKS(20));
       continue;
     }
     // banner
     unsigned long t0 = millis();
-    while (!cli.available() && cli.connected() && millis() - t0 < 5000) {
+    while (!rx.available() && cli.connected() && millis() - t0 < kDucoBannerTimeoutMs) {
       vTaskDelay(pdMS_TO_TICKS(10));
     }
-    if (!cli.available()) {
+    if (!rx.available()) {
       cli.stop();
+      duco_pool_nodes::reportConnect(node, false);
       g_poolDiagText = "Pool node is not responding.";
-      vTaskDelay(pdMS_TO_TICKS(2000));
+      vTaskDelay(pdMS_TO_TICKS(20));
       continue;
     }
-    String serverVer = cli.readStringUntil('\n');
-    g_status       = String("connected (") + tag + ") " + g_nodeName;
-    serverVer.trim();
+    duco_pool_nodes::reportConnect(node, true);
+    char line[duco_protocol::kMaxLine];
+    char text[duco_protocol::kMaxLine];
+    size_t lineLen = ducoReadLine_(rx, line, sizeof(line));
+    duco_protocol::trimCopy(text, sizeof(text), line, lineLen);
     g_poolDiagText = "";
-    MC_LOGD("DUCO", "%s server version: %s", tag, serverVer.c_str());
-    me.connected_ = true;
+    MC_LOGD("DUCO", "%s server version: %s", tag, text);
+    cs.connected_ = true;
+    g_nodeName = node.name_;
     g_status = String("connected (") + tag + ") " + g_nodeName;
+    // New session: results of the previous one are stale.
+    xQueueReset(g_resultQ[ci]);
+    const uint32_t gen = ++g_connGen[ci];
     // ===== JOB loop =====
     while (cli.connected()) {
       // disabled mid-connection -> disconnect and go idle
-      if (idx >= (int)g_miningActiveThreads) {
+      if (ci >= ducoWantedConns_()) {
         MC_LOGI("DUCO", "%s disabled -> disconnect", tag);
         cli.stop();
-        me.connected_   = false;
-        me.hashrateKh_ = 0.0f;
+        cs.connected_ = false;
         vTaskDelay(pdMS_TO_TICKS(200));
         break;
       }
       // NOTE:
-      String req = String("JOB,") + cfg.ducoUser_ + ",LOW," +
-                  cfg.ducoMinerKey_ + "\n";
+      char req[duco_protocol::kMaxLine];
+      const size_t reqLen = duco_protocol::buildJobRequest(
+          req, sizeof(req), cfg.ducoUser_, cfg.ducoMinerKey_);
       MC_LOGT("DUCO", "%s send JOB user=%s board=LOW", tag, cfg.ducoUser_);
       unsigned long ping0 = millis();
-      cli.print(req);
+      cli.write((const uint8_t*)req, reqLen);
       t0 = millis();
-      while (!cli.available() && cli.connected() && millis() - t0 < 10000) {
+      while (!rx.available() && cli.connected() && millis() - t0 < 10000) {
         vTaskDelay(pdMS_TO_TICKS(10));
       }
-      if (!cli.available()) {
-        me.connected_ = false;
+      if (!rx.available()) {
+        cs.connected_ = false;
         g_status = String("no job (") + tag + ")";
         MC_LOGI_RL("duco_no_job", 10000, "DUCO",
                    "%s no job (timeout)", tag);
         g_poolDiagText = "No job response from the pool.";
+        // Stalled node: bench it so the reconnect goes elsewhere.
+        if (cli.connected()) duco_pool_nodes::reportConnect(node, false);
         break;
       }
-      me.lastPingMs_ = (float)(millis() - ping0);
-      MC_LOGT("DUCO", "%s job ping = %.1f ms", tag, me.lastPingMs_);
+      cs.lastPingMs_ = (float)(millis() - ping0);
+      duco_pool_nodes::reportRtt(node, cs.lastPingMs_);
+      MC_LOGT("DUCO", "%s job ping = %.1f ms", tag, cs.lastPingMs_.load());
       // job: previousHash,expectedHash,difficulty\n
-      String prev     = cli.readStringUntil(',');
-      String expected = cli.readStringUntil(',');
-      String diffStr  = cli.readStringUntil('\n');
-      prev.trim();
-      expected.trim();
-      diffStr.trim();
-      int difficulty = diffStr.toInt();
-      if (difficulty <= 0) difficulty = 1;
-      me.difficulty_ = (uint32_t)difficulty;
-      portENTER_CRITICAL(&g_statsMux);
-      me.workDiff_ = (uint32_t)difficulty;
-      me.workValid_ = false;
-      strncpy(me.workSeed_, prev.c_str(), 40);
-      me.workSeed_[40] = '\0';
-      portEXIT_CRITICAL(&g_statsMux);
-      MC_LOGT("DUCO", "%s job diff=%d prev=%s expected=%s",
-              tag, difficulty, prev.c_str(), expected.c_str());
-        const size_t shaLen = 20;
-        unsigned char expBytes[shaLen];
-      memset(expBytes, 0, sizeof(expBytes));
-      size_t elen = expected.length() / 2;
-      const char* ce = expected.c_str();
-      auto h = [](char c) -> uint8_t {
-        c = toupper((uint8_t)c);
-        if (c >= '0' && c <= '9') return (uint8_t)(c - '0');
-        if (c >= 'A' && c <= 'F') return (uint8_t)(c - 'A' + 10);
-        return 0;
-      };
-        for (size_t i = 0, j = 0; j < elen && j < shaLen; i += 2, ++j) {
-          expBytes[j] = (h(ce[i]) << 4) | h(ce[i + 1]);
-        }
-      // solve
-      uint32_t hashes = 0;
-      unsigned long tStart = micros();
-      uint32_t foundNonce =
-          ducoSolveDucoS1_(prev, expBytes, (uint32_t)difficulty, hashes, &me);
-      if (foundNonce == kDucoAborted) {
-        // mining control requested to stop this thread
-        MC_EVT("DUCO", "%s job aborted by control", tag);
+      lineLen = ducoReadLine_(rx, line, sizeof(line));
+      duco_protocol::Job parsed;
+      if (!duco_protocol::parseJob(line, lineLen, parsed)) {
+        duco_protocol::trimCopy(text, sizeof(text), line, lineLen);
+        MC_LOGD("DUCO", "%s bad job line: '%s'", tag, text);
+        g_poolDiagText = "Pool sent an unexpected job line.";
+        break;
+      }
+      cs.difficulty_ = parsed.difficulty_;
+      MC_LOGT("DUCO", "%s job diff=%u prev=%s",
+              tag, (unsigned)parsed.difficulty_, parsed.seed_);
+      DucoJobMsg job;
+      job.conn_ = (uint8_t)ci;
+      job.connGen_ = gen;
+      job.difficulty_ = parsed.difficulty_;
+      memcpy(job.seed_, parsed.seed_, parsed.seedLen_ + 1);
+      job.seedLen_ = parsed.seedLen_;
+      memcpy(job.target_, parsed.target_, sizeof(job.target_));
+      // Hand off; at most one job per connection is in flight, so the queue
+      // (g_connections deep) never blocks here.
+      xQueueSend(g_jobQ, &job, 0);
+      DucoResultMsg res;
+      if (!ducoWaitResult_(ci, cli, job, res)) {
+        MC_EVT("DUCO", "%s job dropped (disabled or disconnected)", tag);
         cli.stop();
-        me.connected_   = false;
-        me.hashrateKh_ = 0.0f;
+        cs.connected_ = false;
         vTaskDelay(pdMS_TO_TICKS(200));
         break;
       }
-      float sec = (micros() - tStart) / 1000000.0f;
-      if (sec <= 0) sec = 0.001f;
-      float hps = hashes / (sec > 0 ? sec : 0.001f);
-      MC_LOGT("DUCO", "%s solved nonce=%u hashes=%u time=%.3fs (%.1f H/s)",
-              tag,
-              (unsigned)foundNonce,
-              (unsigned)hashes,
-              sec,
-              hps);
-      if (foundNonce == UINT32_MAX) {
+      if (res.nonce_ == UINT32_MAX) {
         g_status = String("no share (") + tag + ")";
         vTaskDelay(pdMS_TO_TICKS(5));
         continue;
       }
-      me.hashrateKh_ = hps / 1000.0f;
-      me.shares_++;
+      const uint32_t foundNonce = res.nonce_;
+      const float hps = res.hps_;
+      cs.shares_++;
       // Submit: nonce,hashrate,banner ver,rig,DUCOID<chip>,<walletid>\n
-      String submit =
-          String(foundNonce) + "," + String(hps) + "," +
-          String(cfg.ducoBanner_) + " " + cfg.appVersion_ + "," +
-          cfg.ducoRigName_ + "," +
-          "DUCOID" + String((char*)g_chipId) + "," +
-          String(g_walletId) + "\n";
-      cli.print(submit);
+      const size_t submitLen = duco_protocol::buildSubmit(
+          line, sizeof(line), foundNonce, hps, cfg.ducoBanner_,
+          cfg.appVersion_, cfg.ducoRigName_, g_chipId, g_walletId);
+      cli.write((const uint8_t*)line, submitLen);
       MC_LOGT("DUCO", "%s submit nonce=%u hps=%.1f",
               tag, (unsigned)foundNonce, hps);
       // feedback
       t0 = millis();
-      while (!cli.available() && cli.connected() && millis() - t0 < 10000) {
+      while (!rx.available() && cli.connected() && millis() - t0 < 10000) {
         vTaskDelay(pdMS_TO_TICKS(10));
       }
-      if (!cli.available()) {
+      if (!rx.available()) {
         g_status = String("no feedback (") + tag + ")";
-        ++me.rejected_;
+        ++cs.rejected_;
         ++g_rejAll;
         MC_LOGI_RL("duco_no_feedback", 10000, "DUCO",
                    "%s no feedback (timeout)", tag);
         g_poolDiagText = "No result response from the pool.";
         break;
       }
-      String fb = cli.readStringUntil('\n');
-      fb.trim();
-      MC_LOGD("DUCO", "%s feedback: '%s'", tag, fb.c_str());
-      bool ok = fb.startsWith("GOOD");
+      lineLen = ducoReadLine_(rx, line, sizeof(line));
+      duco_protocol::trimCopy(text, sizeof(text), line, lineLen);
+      MC_LOGD("DUCO", "%s feedback: '%s'", tag, text);
+      // BLOCK: the share also found a block, so it counts as accepted.
+      const duco_protocol::Feedback fb = duco_protocol::parseFeedback(line, lineLen);
+      bool ok = (fb == duco_protocol::Feedback::Good ||
+                 fb == duco_protocol::Feedback::Block);
+      duco_pool_nodes::reportShare(node, ok);
       if (ok) {
-        ++me.accepted_;
+        ++cs.accepted_;
         ++g_accAll;
-        g_status = String("share GOOD (#") + String(me.shares_) +
+        g_status = String("share GOOD (#") + String(cs.shares_.load()) +
                    ", " + tag + ")";
         g_poolDiagText = "";
       } else {
-        ++me.rejected_;
+        ++cs.rejected_;
         ++g_rejAll;
-        g_status = String("share BAD (#") + String(me.shares_) +
+        g_status = String("share BAD (#") + String(cs.shares_.load()) +
                    ", " + tag + ")";
       }
       MC_LOGI_RL("duco_share_result", 3000, "DUCO",
                  "%s share %s (#%lu)",
-                 tag, ok ? "GOOD" : "BAD", (unsigned long)me.shares_);
+                 tag, ok ? "GOOD" : "BAD", (unsigned long)cs.shares_.load());
       vTaskDelay(pdMS_TO_TICKS(5));
     }
+    // Session over: jobs still queued for it are skipped by the workers.
+    ++g_connGen[ci];
     cli.stop();
-    me.connected_ = false;
-    vTaskDelay(pdMS_TO_TICKS(2000));
+    cs.connected_ = false;
+  }
+}
+// Solver worker: takes jobs from any connection, hashes, posts the result
+// back to that connection. No socket I/O here.
+static void ducoWorkerTask_(void* pv) {
+  int idx = (int)(intptr_t)pv;
+  if (idx < 0 || idx >= g_minerThreads) idx = 0;
+  auto& me = g_thr[idx];
+  char tag[8];
+  snprintf(tag, sizeof(tag), "T%d", idx);
+  MC_LOGI("DUCO", "miner task start %s", tag);
+  if (MC_DUCO_COOP && idx > 0) {
+    ducoCoopHelper_(idx, me);
+  }
+  for (;;) {
+    // ----- mining control: idle if this thread is disabled (STOP/HALF) -----
+    if (idx >= (int)g_miningActiveThreads) {
+      me.hashrateKh_ = 0.0f;
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+    }
+    DucoJobMsg job;
+    if (xQueueReceive(g_jobQ, &job, portMAX_DELAY) != pdTRUE) continue;
+    if (job.connGen_ != g_connGen[job.conn_]) continue;  // connection gone
+    if (idx >= (int)g_miningActiveThreads) {
+      // Disabled while blocked on the queue: leave the job to the others.
+      xQueueSendToFront(g_jobQ, &job, 0);
+      continue;
+    }
+    workWriteBegin_(me);
+    me.work_.diff_ = job.difficulty_;
+    me.work_.valid_ = false;
+    strncpy(me.work_.seed_, job.seed_, 40);
+    me.work_.seed_[40] = '\0';
+    workWriteEnd_(me);
+    // solve
+    me.busy_ = true;
+    uint32_t hashes = 0;
+    uint32_t resumeNonce = 0;
+    unsigned long tStart = micros();
+    // Cooperative jobs restart from 0 (blocks are handed out by index).
+    uint32_t foundNonce = MC_DUCO_COOP ? ducoSolveCoop_(job, hashes, &me)
+                                       : ducoSolveDucoS1_(job, hashes, resumeNonce, &me);
+    me.busy_ = false;
+    const uint32_t us = (uint32_t)(micros() - tStart);
+    // H/s over the whole job, including attempts before an abort.
+    float sec = (us + job.doneUs_) / 1000000.0f;
+    if (sec <= 0) sec = 0.001f;
+    float hps = (hashes + job.doneHashes_) / sec;
+    if (foundNonce == kDucoAborted) {
+      // mining control requested to stop this thread (or the connection dropped)
+      MC_EVT("DUCO", "%s job aborted by control (resume at %u)",
+             tag, (unsigned)resumeNonce);
+      me.hashrateKh_ = 0.0f;
+    } else {
+      MC_LOGT("DUCO", "%s C%u solved nonce=%u hashes=%u time=%.3fs (%.1f H/s)",
+              tag,
+              (unsigned)job.conn_,
+              (unsigned)foundNonce,
+              (unsigned)hashes,
+              sec,
+              hps);
+      if (foundNonce != UINT32_MAX) me.hashrateKh_ = hps / 1000.0f;
+    }
+    DucoResultMsg res;
+    res.connGen_ = job.connGen_;
+    res.nonce_ = foundNonce;
+    res.hashes_ = hashes;
+    res.hps_ = hps;
+    res.resumeNonce_ = resumeNonce;
+    res.us_ = us;
+    xQueueOverwrite(g_resultQ[job.conn_], &res);
   }
 }
 void startMiner() {
@@ -412,8 +918,20 @@ void startMiner() {
   if (!features.miningEnabled_) {
     g_status = "disabled";
     g_poolDiagText = "Mining is disabled (Duco user is empty).";
+    g_miningActiveThreads = 0;
     return;
   }
+  if (g_thr) return;  // already running
+  const uint8_t threads = mcCfgMinerThreads();
+  g_thr = new (std::nothrow) DucoThreadStats[threads];
+  if (!g_thr) {
+    g_status = "no memory";
+    g_miningActiveThreads = 0;
+    return;
+  }
+  g_minerThreads = threads;
+  g_connections  = (uint8_t)(threads + 1);
+  if (g_miningActiveThreads > g_minerThreads) g_miningActiveThreads = g_minerThreads;
   g_shaMutex = xSemaphoreCreateMutex();
   uint64_t chipid = ESP.getEfuseMac();
   uint16_t chip   = (uint16_t)(chipid >> 32);
@@ -422,40 +940,228 @@ void startMiner() {
   randomSeed((uint32_t)millis());
   g_walletId = random(0, 2811);
   WiFi.setSleep(false);
-  for (int i = 0; i < kDucoMinerThreads; ++i) {
-    g_thr[i] = DucoThreadStats();
+  for (int i = 0; i < g_minerThreads; ++i) {
+    g_thr[i].reset();
+  }
+  for (int i = 0; i < g_connections; ++i) {
+    g_conn[i].reset();
   }
-  g_accAll = g_rejAll = 0;
-  for (int i = 0; i < kDucoMinerThreads; ++i) {
-    int core = (i == 0) ? 0 : 1;
-    UBaseType_t prio = 1;
+  g_accAll.store(0);
+  g_rejAll.store(0);
+  // Warm start from the node cache; refresh it from getPool in the background
+  // (8 KB stack: TLS GET + JSON parse, as on the miner task before).
+  const size_t cachedNodes = duco_pool_nodes::begin(kDucoPoolUrl);
+  if (cachedNodes) {
+    MC_EVT("DUCO", "node cache: %u node(s), warm start", (unsigned)cachedNodes);
+  }
+  xTaskCreatePinnedToCore(ducoPoolRefreshTask_, "DucoPool", 8192,
+                          (void*)(intptr_t)(cachedNodes ? 1 : 0), 1,
+                          &g_poolRefreshTask, 0);
+  g_miningEvents = xEventGroupCreate();
+  if (!g_miningPaused) xEventGroupSetBits(g_miningEvents, kMiningRunBit);
+  g_jobQ = xQueueCreate(g_connections, sizeof(DucoJobMsg));
+  for (int i = 0; i < g_connections; ++i) {
+    g_resultQ[i] = xQueueCreate(1, sizeof(DucoResultMsg));
+  }
+  const char* cores = mcCfgMinerCores();
+  const size_t coresLen = strlen(cores);
+  const UBaseType_t prio = mcCfgMinerPrio();
+  const uint32_t stack = mcCfgMinerStack();
+  MC_EVT("DUCO", "miner topology: threads=%u cores=%s prio=%u stack=%lu",
+         (unsigned)g_minerThreads, cores, (unsigned)prio, (unsigned long)stack);
+  for (int i = 0; i < g_minerThreads; ++i) {
+    // A list shorter than the task count repeats; 'x' = no affinity.
+    const char c = coresLen ? cores[i % coresLen] : 'x';
+    const BaseType_t core = (c == '0') ? 0 : (c == '1') ? 1 : tskNO_AFFINITY;
     String name = String("DucoMiner") + String(i);
-    xTaskCreatePinnedToCore(ducoTask_,
+    xTaskCreatePinnedToCore(ducoWorkerTask_,
                             name.c_str(),
-                            8192,
+                            stack,
                             (void*)(intptr_t)i,
                             prio,
-                            nullptr,
+                            &g_minerTask[i],
                             core);
   }
+  // Net tasks mostly block on sockets/queues; one above the miners so a
+  // finished job is submitted and the next one fetched without waiting for
+  // a yield point. 8 KB: the getPool fallback runs a TLS request here.
+  for (int i = 0; i < g_connections; ++i) {
+    String name = String("DucoNet") + String(i);
+    xTaskCreatePinnedToCore(ducoNetTask_,
+                            name.c_str(),
+                            8192,
+                            (void*)(intptr_t)i,
+                            prio + 1,
+                            &g_netTask[i],
+                            i % 2);
+  }
+}
+// ===== Yield autotuner =====
+static bool yieldAutoActive_() {
+  const MiningYieldProfile n = MiningYieldNormal();
+  return MC_MINING_YIELD_AUTOTUNE && g_yieldReq.every_ == n.every_ &&
+         g_yieldReq.delayMs_ == n.delayMs_;
+}
+static void applyYield_() {
+  uint16_t every = g_yieldReq.every_;
+  uint8_t  ms    = g_yieldReq.delayMs_;
+  if (yieldAutoActive_()) {
+    every = g_yieldTuner.every();
+    ms    = g_yieldTuner.delayMs();
+  }
+  // Keep the limit when it sleeps more per hash (ms / every, cross-multiplied).
+  if (g_yieldLimit.every_ &&
+      (uint32_t)g_yieldLimit.delayMs_ * every > (uint32_t)ms * g_yieldLimit.every_) {
+    every = g_yieldLimit.every_;
+    ms    = g_yieldLimit.delayMs_;
+  }
+  g_yieldEvery = every;
+  g_yieldMs    = ms;
+}
+static void yieldTunerInit_() {
+  if (g_yieldTunerReady) return;
+  MiningYieldTunerConfig cfg;
+  cfg.loopLateBudgetUs_ = MC_MINING_YIELD_LOOP_LATE_US;
+  cfg.frameBudgetUs_    = MC_MINING_YIELD_FRAME_US;
+  g_yieldTuner.begin(cfg);
+  g_yieldTunerReady = true;
+}
+// UI loop only (same task as the notes below).
+static void yieldTunerStep_(uint32_t nowMs, float totalKh) {
+  yieldTunerInit_();
+  const bool active = yieldAutoActive_() && !g_miningPaused &&
+                      g_miningActiveThreads > 0 && totalKh > 0.0f;
+  if (!g_yieldTuner.update(nowMs, totalKh, active)) return;
+  applyYield_();
+  MC_EVT("MINING", "yield auto L%u %u/%ums (%s) late=%luus frame=%luus kh=%.1f",
+         (unsigned)g_yieldTuner.level(), (unsigned)g_yieldEvery, (unsigned)g_yieldMs,
+         g_yieldTuner.stateName(),
+         (unsigned long)g_yieldTuner.loopLatePeakUs(),
+         (unsigned long)g_yieldTuner.framePeakUs(), totalKh);
+}
+// Push the counter deltas of the whole seconds since the last call into
+// g_series (a stalled loop is spread over the seconds it missed).
+static void seriesSample_(uint32_t nowMs, float pingMs) {
+  static uint32_t s_lastMs = 0;
+  static uint32_t s_lastHashes = 0, s_lastAcc = 0, s_lastRej = 0;
+  uint32_t hashes = 0;
+  for (int i = 0; i < g_minerThreads; ++i) {
+    hashes += g_thr[i].hashes_.load(std::memory_order_relaxed);
+  }
+  const uint32_t acc = g_accAll, rej = g_rejAll;
+  if (s_lastMs == 0) {
+    s_lastMs = nowMs ? nowMs : 1;
+    s_lastHashes = hashes;
+    s_lastAcc = acc;
+    s_lastRej = rej;
+    return;
+  }
+  const uint32_t secs = (nowMs - s_lastMs) / 1000;
+  if (secs == 0) return;
+  s_lastMs += secs * 1000;
+  // Share counters restart with startMiner(); a drop is not a delta.
+  g_series.push(secs, hashes - s_lastHashes,
+                (acc >= s_lastAcc) ? acc - s_lastAcc : 0,
+                (rej >= s_lastRej) ? rej - s_lastRej : 0, pingMs);
+  s_lastHashes = hashes;
+  s_lastAcc = acc;
+  s_lastRej = rej;
+}
+// Per-core / per-task hashrate over MC_DUCO_MEASURE_MS windows; logged when
+// miner_measure is on so topologies can be compared on the same build.
+static void topologySample_(uint32_t nowMs, MiningSummary& out) {
+  static_assert(portNUM_PROCESSORS <= 2, "MiningSummary::coreKh_ holds two cores");
+  static uint32_t s_lastMs = 0;
+  static uint32_t s_lastCore[portNUM_PROCESSORS] = {0};
+  static uint32_t s_lastThr[kDucoMaxMinerThreads] = {0};
+  static float    s_coreKh[2] = {0.0f, 0.0f};
+  const bool first = (s_lastMs == 0);
+  if (!first && nowMs - s_lastMs < MC_DUCO_MEASURE_MS) {
+    memcpy(out.coreKh_, s_coreKh, sizeof(s_coreKh));
+    return;
+  }
+  const uint32_t dtMs = nowMs - s_lastMs;
+  s_lastMs = nowMs ? nowMs : 1;
+  float thrKh[kDucoMaxMinerThreads] = {0};
+  for (int c = 0; c < portNUM_PROCESSORS; ++c) {
+    const uint32_t h = g_coreHashes[c].load(std::memory_order_relaxed);
+    if (!first && dtMs) s_coreKh[c] = (float)(h - s_lastCore[c]) / (float)dtMs;
+    s_lastCore[c] = h;
+  }
+  for (int i = 0; i < g_minerThreads; ++i) {
+    const uint32_t h = g_thr[i].hashes_.load(std::memory_order_relaxed);
+    if (!first && dtMs) thrKh[i] = (float)(h - s_lastThr[i]) / (float)dtMs;
+    s_lastThr[i] = h;
+  }
+  memcpy(out.coreKh_, s_coreKh, sizeof(s_coreKh));
+  if (first || !mcCfgMinerMeasure()) return;
+  char thr[80];
+  size_t n = 0;
+  thr[0] = '\0';
+  for (int i = 0; i < g_minerThreads && n < sizeof(thr); ++i) {
+    const int core = g_thr[i].core_.load(std::memory_order_relaxed);
+    n += snprintf(thr + n, sizeof(thr) - n, " T%d=%.1f@%c", i, thrKh[i],
+                  core < 0 ? '?' : (char)('0' + core));
+  }
+  MC_EVT("MINING", "measure threads=%u cores=%s prio=%u solver=%u | c0=%.1f c1=%.1f kH/s |%s",
+         (unsigned)g_minerThreads, mcCfgMinerCores(), (unsigned)mcCfgMinerPrio(),
+         (unsigned)MC_DUCO_SOLVER, s_coreKh[0], s_coreKh[1], thr);
 }
 void updateMiningSummary(MiningSummary& out) {
   const auto features = getRuntimeFeatures();
-  float    totalKh = 0.0f;
   float    maxPing  = 0.0f;
   uint32_t acc = 0, rej = 0, diff = 0;
   g_anyConnected = false;
-  for (int i = 0; i < kDucoMinerThreads; ++i) {
-    totalKh += g_thr[i].hashrateKh_;
-    acc      += g_thr[i].accepted_;
-    rej      += g_thr[i].rejected_;
-    if (g_thr[i].difficulty_ > diff) diff = g_thr[i].difficulty_;
-    if (g_thr[i].connected_) g_anyConnected = true;
-    if (g_thr[i].lastPingMs_ > maxPing) {
-      maxPing = g_thr[i].lastPingMs_;
+  for (int i = 0; i < g_connections; ++i) {
+    acc      += g_conn[i].accepted_;
+    rej      += g_conn[i].rejected_;
+    if (g_conn[i].difficulty_ > diff) diff = g_conn[i].difficulty_;
+    if (g_conn[i].connected_) g_anyConnected = true;
+    if (g_conn[i].lastPingMs_ > maxPing) {
+      maxPing = g_conn[i].lastPingMs_;
     }
   }
+  // Duty cycle: hashing time of the active workers over wall time, per ~1 s.
+  static uint32_t s_dutyLastMs = 0;
+  static uint32_t s_dutyLastBusy[kDucoMaxMinerThreads] = {0};
+  static float    s_dutyPct = 0.0f;
+  const uint32_t nowMs = millis();
+  if (s_dutyLastMs == 0 || nowMs - s_dutyLastMs >= 1000) {
+    const uint32_t dtMs = nowMs - s_dutyLastMs;
+    const int active = (int)g_miningActiveThreads;
+    float busyUs = 0.0f;
+    for (int i = 0; i < g_minerThreads; ++i) {
+      const uint32_t b = g_thr[i].busyUs_;
+      if (i < active) busyUs += (float)(b - s_dutyLastBusy[i]);
+      s_dutyLastBusy[i] = b;
+    }
+    if (s_dutyLastMs != 0 && active > 0 && dtMs > 0) {
+      s_dutyPct = busyUs / ((float)dtMs * 10.0f * (float)active);
+      if (s_dutyPct > 100.0f) s_dutyPct = 100.0f;
+    } else if (active <= 0) {
+      s_dutyPct = 0.0f;
+    }
+    s_dutyLastMs = nowMs;
+  }
+  out.dutyPct_ = s_dutyPct;
+  seriesSample_(nowMs, maxPing);
+  topologySample_(nowMs, out);
+  // Smoothed rate for display; the tuner compares levels over its own window.
+  const float totalKh = g_series.ewma(SeriesMetric::HashRate) / 1000.0f;
+  const size_t tunerSecs = (MiningYieldTunerConfig().windowMs_ + 999) / 1000;
+  yieldTunerStep_(nowMs, g_series.mean(SeriesScale::Second, SeriesMetric::HashRate,
+                                       tunerSecs) / 1000.0f);
+  out.yieldEvery_ = g_yieldEvery;
+  out.yieldMs_    = g_yieldMs;
+  out.yieldAuto_  = yieldAutoActive_();
+  out.yieldState_ = g_yieldTuner.stateName();
+  out.gov_        = g_govState;
   out.totalKh_      = totalKh;
+  out.khMin1m_      = g_series.minOf(SeriesScale::Second, SeriesMetric::HashRate) / 1000.0f;
+  out.khMax1m_      = g_series.maxOf(SeriesScale::Second, SeriesMetric::HashRate) / 1000.0f;
+  out.khP50_1m_     = g_series.percentile(SeriesScale::Second, SeriesMetric::HashRate, 50.0f) / 1000.0f;
+  out.sharesPerMin_ = g_series.ewma(SeriesMetric::ShareRate);
+  out.pingP90Ms_    = g_series.percentile(SeriesScale::Second, SeriesMetric::PingMs, 90.0f);
   out.accepted_      = acc;
   out.rejected_      = rej;
   out.maxDifficulty_ = diff;
@@ -465,46 +1171,39 @@ void updateMiningSummary(MiningSummary& out) {
   out.miningEnabled_ = features.miningEnabled_;
   char logbuf[64];
   snprintf(logbuf, sizeof(logbuf),
-           "%s A%u R%u HR %.1fkH/s d%u",
+           "%s A%u R%u HR %.1fkH/s %.1f/m d%u dc%u%%",
            g_status.startsWith("share GOOD") ? "good " :
            g_status.startsWith("share BAD")  ? "rej  " :
            g_anyConnected ? "alive" : "dead ",
-           (unsigned)acc, (unsigned)rej, totalKh, (unsigned)diff);
+           (unsigned)acc, (unsigned)rej, totalKh, out.sharesPerMin_, (unsigned)diff,
+           (unsigned)(s_dutyPct + 0.5f));
   out.logLine40_ = String(logbuf);
   out.poolDiag_ = g_poolDiagText;
   auto hexDigit = [](uint8_t v) -> char {
     return (v < 10) ? (char)('0' + v) : (char)('a' + (v - 10));
   };
-  int wiConnected = -1;
-  int wiAny = -1;
-  for (int i = 0; i < kDucoMinerThreads; ++i) {
-    if (g_thr[i].workValid_) {
-        if (wiAny < 0) wiAny = i;
-        if (g_thr[i].connected_ && wiConnected < 0) wiConnected = i;
+  // Prefer a worker that is on a job right now.
+  DucoWork work;
+  int wi = -1;
+  for (int pass = 0; pass < 2 && wi < 0; ++pass) {
+    for (int i = 0; i < g_minerThreads; ++i) {
+      if (pass == 0 && !g_thr[i].busy_.load()) continue;
+      if (workRead_(g_thr[i], work) && work.valid_) {
+        wi = i;
+        break;
+      }
     }
   }
-  int wi = (wiConnected >= 0) ? wiConnected : wiAny;
   if (wi >= 0) {
-    uint8_t out20[20];
-    char seed40[41];
-    uint32_t nonce = 0, maxNonce = 0, diffv = 0;
-    portENTER_CRITICAL(&g_statsMux);
-    nonce   = g_thr[wi].workNonce_;
-    maxNonce= g_thr[wi].workMaxNonce_;
-    diffv   = g_thr[wi].workDiff_;
-    memcpy(out20, g_thr[wi].workOut_, 20);
-    strncpy(seed40, g_thr[wi].workSeed_, 40);
-    seed40[40] = '\0';
-    portEXIT_CRITICAL(&g_statsMux);
     out.workThread_     = (uint8_t)wi;
-    out.workNonce_      = nonce;
-    out.workMaxNonce_   = maxNonce;
-    out.workDifficulty_ = diffv;
-    strncpy(out.workSeed_, seed40, 40);
+    out.workNonce_      = work.nonce_;
+    out.workMaxNonce_   = work.maxNonce_;
+    out.workDifficulty_ = work.diff_;
+    strncpy(out.workSeed_, work.seed_, 40);
     out.workSeed_[40] = '\0';
     for (int j = 0; j < 20; ++j) {
-      out.workHashHex_[j * 2 + 0] = hexDigit((out20[j] >> 4) & 0x0F);
-      out.workHashHex_[j * 2 + 1] = hexDigit(out20[j] & 0x0F);
+      out.workHashHex_[j * 2 + 0] = hexDigit((work.out_[j] >> 4) & 0x0F);
+      out.workHashHex_[j * 2 + 1] = hexDigit(work.out_[j] & 0x0F);
     }
     out.workHashHex_[40] = '\0';
   } else {
@@ -516,8 +1215,11 @@ void updateMiningSummary(MiningSummary& out) {
 }
 // ===== Mining control API (public) =====
 void setMiningActiveThreads(uint8_t activeThreads) {
-  if (activeThreads > kDucoMinerThreads) activeThreads = kDucoMinerThreads;
+  const uint8_t cap = g_minerThreads ? g_minerThreads : kDucoMaxMinerThreads;
+  if (activeThreads > cap) activeThreads = cap;
   g_miningActiveThreads = activeThreads;
+  g_miningPoke = g_miningPoke + 1;
+  ducoWakeAll_();
 }
 uint8_t getMiningActiveThreads() {
   return g_miningActiveThreads;
@@ -525,13 +1227,25 @@ uint8_t getMiningActiveThreads() {
 void setMiningYieldProfile(MiningYieldProfile p) {
   // normalize 'every' to power-of-two (fast bitmask check)
   p.every_ = normalizePow2_(p.every_);
-  g_yieldEvery = p.every_;
-  g_yieldMs    = p.delayMs_;
+  g_yieldReq = p;
+  applyYield_();
 }
+// The requested profile (callers save / restore it), not the tuned one.
 MiningYieldProfile getMiningYieldProfile() {
-  MiningYieldProfile p;
-  p.every_    = g_yieldEvery;
-  p.delayMs_ = g_yieldMs;
-  return p;
+  return g_yieldReq;
+}
+void noteMiningLoopLateUs(uint32_t us) {
+  g_yieldTuner.noteLoopLate(us);
+}
+void noteMiningUiFrameUs(uint32_t us) {
+  g_yieldTuner.noteFrame(us);
+}
+void setMiningYieldLimit(MiningYieldProfile p) {
+  if (p.every_) p.every_ = normalizePow2_(p.every_);
+  g_yieldLimit = p;
+  applyYield_();
+}
+void setMiningGovernorState(const MiningGovernorState& st) {
+  g_govState = st;
 }
 
@@ -20,3 +20,12 @@ void setMiningYieldProfile(MiningYieldProfile p);
 MiningYieldProfile getMiningYieldProfile();
 inline MiningYieldProfile MiningYieldNormal() { return MiningYieldProfile(1024, 1); }
 inline MiningYieldProfile MiningYieldStrong() { return MiningYieldProfile(64, 3); }
+// UI timing for the yield autotuner (call from the UI loop task):
+// how late the loop woke up after its delay, and one frame's draw time.
+void noteMiningLoopLateUs(uint32_t us);
+void noteMiningUiFrameUs(uint32_t us);
+// Upper bound on hashing between yields (governor): the effective profile is
+// whichever of request / limit sleeps more per hash. every_ = 0 clears it.
+void setMiningYieldLimit(MiningYieldProfile p);
+// Governor policy snapshot, copied into MiningSummary::gov_.
+void setMiningGovernorState(const MiningGovernorState& st);
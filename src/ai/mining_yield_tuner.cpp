@@ -0,0 +1,118 @@
+// Module implementation.
+#include "ai/mining_yield_tuner.h"
+
+namespace {
+struct YieldStep {
+  uint16_t every_;
+  uint8_t  delayMs_;
+};
+// Most UI-friendly first; index kStartLevel is MiningYieldNormal().
+static const YieldStep kLadder[MiningYieldTuner::kLevelCount] = {
+  {64, 3}, {128, 2}, {256, 1}, {512, 1}, {1024, 1},
+  {2048, 1}, {4096, 1}, {8192, 1}, {16384, 1},
+};
+// A climb has to buy at least this much kH/s to be kept.
+static const float kMinGain = 1.005f;
+} // namespace
+
+void MiningYieldTuner::begin(const MiningYieldTunerConfig& cfg) {
+  *this = MiningYieldTuner();
+  cfg_ = cfg;
+  if (cfg_.windowMs_ == 0) cfg_.windowMs_ = 1;
+}
+
+void MiningYieldTuner::noteLoopLate(uint32_t us) {
+  if (us > latePeak_) latePeak_ = us;
+}
+
+void MiningYieldTuner::noteFrame(uint32_t us) {
+  if (us > framePeak_) framePeak_ = us;
+  ++frames_;
+}
+
+uint16_t MiningYieldTuner::every() const { return kLadder[level_].every_; }
+uint8_t MiningYieldTuner::delayMs() const { return kLadder[level_].delayMs_; }
+
+const char* MiningYieldTuner::stateName() const {
+  switch (state_) {
+    case State::Idle:    return "idle";
+    case State::Hold:    return "hold";
+    case State::Climb:   return "climb";
+    case State::Back:    return "back";
+    case State::Plateau: return "plateau";
+    default: return "?";
+  }
+}
+
+void MiningYieldTuner::hold_(uint32_t nowMs) {
+  ceiling_ = level_;
+  ceilingUntilMs_ = nowMs + cfg_.holdMs_;
+}
+
+bool MiningYieldTuner::update(uint32_t nowMs, float totalKh, bool active) {
+  if (windowStartMs_ == 0) {
+    windowStartMs_ = nowMs ? nowMs : 1;
+    return false;
+  }
+  if (nowMs - windowStartMs_ < cfg_.windowMs_) return false;
+  const uint32_t late = latePeak_;
+  const uint32_t frame = framePeak_;
+  const bool haveFrames = frames_ > 0;  // display asleep -> loop lateness only
+  lastLatePeak_ = late;
+  lastFramePeak_ = frame;
+  latePeak_ = framePeak_ = frames_ = 0;
+  windowStartMs_ = nowMs ? nowMs : 1;
+  if (ceiling_ < kLevelCount && (int32_t)(nowMs - ceilingUntilMs_) >= 0) {
+    ceiling_ = kLevelCount;
+  }
+  if (!active) {
+    state_ = State::Idle;
+    settle_ = true;
+    climbed_ = false;
+    return false;
+  }
+  const bool over = late > cfg_.loopLateBudgetUs_ ||
+                    (haveFrames && frame > cfg_.frameBudgetUs_);
+  if (over) {
+    climbed_ = false;
+    if (level_ == 0) {
+      state_ = State::Hold;
+      return false;
+    }
+    hold_(nowMs);
+    --level_;
+    settle_ = true;
+    state_ = State::Back;
+    return true;
+  }
+  // kH/s of the window right after a change mixes both levels.
+  if (settle_) {
+    settle_ = false;
+    state_ = State::Hold;
+    return false;
+  }
+  khAt_[level_] = totalKh;
+  if (climbed_) {
+    climbed_ = false;
+    if (level_ > 0 && totalKh < khAt_[level_ - 1] * kMinGain) {
+      hold_(nowMs);
+      --level_;
+      settle_ = true;
+      state_ = State::Plateau;
+      return true;
+    }
+  }
+  // Climb only with a quarter of both budgets to spare.
+  const bool roomy = (uint64_t)late * 4 <= (uint64_t)cfg_.loopLateBudgetUs_ * 3 &&
+                     (!haveFrames ||
+                      (uint64_t)frame * 4 <= (uint64_t)cfg_.frameBudgetUs_ * 3);
+  if (roomy && level_ + 1 < ceiling_ && level_ + 1 < kLevelCount) {
+    ++level_;
+    climbed_ = true;
+    settle_ = true;
+    state_ = State::Climb;
+    return true;
+  }
+  state_ = State::Hold;
+  return false;
+}
@@ -0,0 +1,63 @@
+// Module implementation.
+// Closed-loop chooser for the miner's yield profile (every N hashes sleep M ms).
+//
+// The UI loop reports how late it wakes up and how long a frame takes; the
+// miner reports kH/s. Once per window the tuner moves one step along a fixed
+// ladder: towards fewer yields while both UI measures stay inside budget and
+// the extra hashing actually shows up in kH/s, back towards more yields as
+// soon as a budget is missed. A missed (or useless) level is not retried
+// until holdMs_ has passed.
+//
+// NOTE:
+// - No Arduino / FreeRTOS here; all calls come from the UI loop task.
+// - Every ladder step sleeps at least 1 ms so IDLE0 still runs (task WDT).
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+struct MiningYieldTunerConfig {
+  uint32_t loopLateBudgetUs_ = 4000;  // worst loop wake-up lateness per window
+  uint32_t frameBudgetUs_ = 50000;    // worst UI frame time per window
+  uint32_t windowMs_ = 3000;
+  uint32_t holdMs_ = 30000;
+};
+
+class MiningYieldTuner {
+public:
+  enum class State : uint8_t { Idle, Hold, Climb, Back, Plateau };
+  static constexpr uint8_t kLevelCount = 9;
+  // Level 4 (1024 / 1 ms) is MiningYieldNormal(), where the tuner starts.
+  static constexpr uint8_t kStartLevel = 4;
+
+  void begin(const MiningYieldTunerConfig& cfg);
+  void noteLoopLate(uint32_t us);
+  void noteFrame(uint32_t us);
+  // active=false (manual profile, paused, not hashing) only keeps measuring.
+  // Returns true when the level changed.
+  bool update(uint32_t nowMs, float totalKh, bool active);
+
+  uint8_t level() const { return level_; }
+  uint16_t every() const;
+  uint8_t delayMs() const;
+  State state() const { return state_; }
+  const char* stateName() const;
+  uint32_t loopLatePeakUs() const { return lastLatePeak_; }
+  uint32_t framePeakUs() const { return lastFramePeak_; }
+
+private:
+  void hold_(uint32_t nowMs);
+  MiningYieldTunerConfig cfg_;
+  uint8_t  level_ = kStartLevel;
+  uint8_t  ceiling_ = kLevelCount;  // levels >= ceiling_ are on hold
+  uint32_t ceilingUntilMs_ = 0;
+  float    khAt_[kLevelCount] = {0};
+  bool     settle_ = true;   // first window after a change is not judged on kH/s
+  bool     climbed_ = false;
+  State    state_ = State::Idle;
+  uint32_t windowStartMs_ = 0;
+  uint32_t latePeak_ = 0;
+  uint32_t framePeak_ = 0;
+  uint32_t frames_ = 0;
+  uint32_t lastLatePeak_ = 0;
+  uint32_t lastFramePeak_ = 0;
+};
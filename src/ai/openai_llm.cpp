@@ -3,9 +3,9 @@
 
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
-#include <WiFiClientSecure.h>
 
 #include "config/config.h"
+#include "utils/https_pool.h"
 #include "utils/logging.h"
 #include "utils/mc_text_utils.h"
 // ---- small helpers ----
@@ -141,14 +141,21 @@ LlmResult generateReply(const String& userText, uint32_t timeoutMs) {
   req["text"]["format"]["type"] = "text";
   String payload;
   serializeJson(req, payload);
-  WiFiClientSecure client;
-  client.setInsecure();
-  client.setTimeout(timeoutMs);
-  HTTPClient http;
+  const char* url = MC_OPENAI_ENDPOINT;
+  https_pool::Lease lease;
+  if (!lease.acquire(url)) {
+    r.ok_ = false;
+    r.err_ = "http_begin_failed";
+    r.tookMs_ = millis() - t0;
+    MC_EVT("LLM", "fail stage=begin took=%lums", (unsigned long)r.tookMs_);
+    return r;
+  }
+  lease.client().setTimeout(timeoutMs);
+  HTTPClient& http = lease.http();
   http.setTimeout(timeoutMs);
   http.setConnectTimeout(timeoutMs);
-  const char* url = MC_OPENAI_ENDPOINT;
-  if (!http.begin(client, url)) {
+  http.setReuse(true);
+  if (!http.begin(lease.client(), url)) {
     r.ok_ = false;
     r.err_ = "http_begin_failed";
     r.tookMs_ = millis() - t0;
@@ -168,6 +175,7 @@ LlmResult generateReply(const String& userText, uint32_t timeoutMs) {
   http.addHeader("Accept", "application/json");
   http.addHeader("Authorization", String("Bearer ") + String(apiKey));
   int code = http.POST((uint8_t*)payload.c_str(), payload.length());
+  if (lease.retryFresh(code, false)) code = http.POST((uint8_t*)payload.c_str(), payload.length());
   r.http_ = code;
   String body;
   if (code > 0) {
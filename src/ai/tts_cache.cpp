@@ -0,0 +1,338 @@
+// Module implementation.
+#include "ai/tts_cache.h"
+
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "audio/payload_arena.h"
+#include "config/config.h"
+#include "utils/logging.h"
+
+namespace tts_cache {
+namespace {
+static const char* kDir = "/ttsc";
+static const char* kIndexPath = "/ttsc/index.json";
+static const char* kTmpPath = "/ttsc/tmp.wav";
+// Hit-only index updates are written at most this often.
+static const uint32_t kSaveEveryMs = 60000;
+static const size_t kWavHeaderBytes = 44;
+
+struct Entry {
+  uint64_t key_ = 0;
+  uint32_t bytes_ = 0;
+  uint32_t use_ = 0;    // g_seq at the last store / hit (LRU order)
+};
+static Entry    g_entries[MC_TTS_CACHE_MAX_ENTRIES];
+static size_t   g_count = 0;
+static uint32_t g_total = 0;
+static uint32_t g_seq = 0;
+static bool     g_ready = false;
+static bool     g_dirty = false;
+static uint32_t g_lastSaveMs = 0;
+static SemaphoreHandle_t g_mutex = nullptr;
+
+struct Lock_ {
+  Lock_() { if (g_mutex) xSemaphoreTake(g_mutex, portMAX_DELAY); }
+  ~Lock_() { if (g_mutex) xSemaphoreGive(g_mutex); }
+};
+
+static void path_(uint64_t key, char* out, size_t cap) {
+  snprintf(out, cap, "%s/%08lx%08lx.wav", kDir,
+           (unsigned long)(key >> 32), (unsigned long)(key & 0xFFFFFFFFu));
+}
+static int find_(uint64_t key) {
+  for (size_t i = 0; i < g_count; ++i) {
+    if (g_entries[i].key_ == key) return (int)i;
+  }
+  return -1;
+}
+// Caller holds the lock.
+static void save_() {
+  JsonDocument doc;
+  doc["seq"] = g_seq;
+  JsonArray arr = doc["e"].to<JsonArray>();
+  for (size_t i = 0; i < g_count; ++i) {
+    char k[17];
+    snprintf(k, sizeof(k), "%08lx%08lx", (unsigned long)(g_entries[i].key_ >> 32),
+             (unsigned long)(g_entries[i].key_ & 0xFFFFFFFFu));
+    JsonObject o = arr.add<JsonObject>();
+    o["k"] = k;
+    o["b"] = g_entries[i].bytes_;
+    o["u"] = g_entries[i].use_;
+  }
+  File f = LittleFS.open(kIndexPath, "w");
+  if (!f) {
+    MC_LOGD("TTS", "cache: index open failed");
+    return;
+  }
+  serializeJson(doc, f);
+  f.close();
+  g_dirty = false;
+  g_lastSaveMs = millis();
+}
+static void removeAt_(size_t i) {
+  char p[40];
+  path_(g_entries[i].key_, p, sizeof(p));
+  LittleFS.remove(p);
+  g_total -= g_entries[i].bytes_;
+  g_entries[i] = g_entries[--g_count];
+}
+// Make room for `need` more bytes and one more entry. Caller holds the lock.
+static void evict_(uint32_t need) {
+  while (g_count > 0 &&
+         (g_count >= MC_TTS_CACHE_MAX_ENTRIES ||
+          (uint64_t)g_total + need > (uint64_t)MC_TTS_CACHE_BUDGET_BYTES)) {
+    size_t lru = 0;
+    for (size_t i = 1; i < g_count; ++i) {
+      if (g_entries[i].use_ < g_entries[lru].use_) lru = i;
+    }
+    MC_LOGD("TTS", "cache: evict %08lx (%luB)",
+            (unsigned long)(g_entries[lru].key_ & 0xFFFFFFFFu),
+            (unsigned long)g_entries[lru].bytes_);
+    removeAt_(lru);
+  }
+}
+// A file now at `from` becomes the entry for `key`. Caller holds the lock.
+static bool adopt_(uint64_t key, const char* from, uint32_t bytes) {
+  const int old = find_(key);
+  if (old >= 0) removeAt_((size_t)old);
+  evict_(bytes);
+  char p[40];
+  path_(key, p, sizeof(p));
+  LittleFS.remove(p);
+  if (!LittleFS.rename(from, p)) {
+    LittleFS.remove(from);
+    return false;
+  }
+  Entry& e = g_entries[g_count++];
+  e.key_ = key;
+  e.bytes_ = bytes;
+  e.use_ = ++g_seq;
+  g_total += bytes;
+  save_();
+  MC_LOGI("TTS", "cache: stored %s (%luB, %u entries, %luB)", p,
+          (unsigned long)bytes, (unsigned)g_count, (unsigned long)g_total);
+  return true;
+}
+static void wavHeader_(uint8_t* h, uint32_t rate, uint32_t dataBytes) {
+  auto w32 = [](uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+  };
+  memcpy(h, "RIFF", 4);
+  w32(h + 4, 36 + dataBytes);
+  memcpy(h + 8, "WAVEfmt ", 8);
+  w32(h + 16, 16);
+  w32(h + 20, 0x00010001u);       // PCM, mono
+  w32(h + 24, rate);
+  w32(h + 28, rate * 2);          // byte rate
+  w32(h + 32, 0x00100002u);       // block align 2, 16 bits
+  memcpy(h + 36, "data", 4);
+  w32(h + 40, dataBytes);
+}
+static bool ready_() {
+  if (!MC_TTS_CACHE) return false;
+  if (!g_ready) begin();
+  return g_ready;
+}
+} // namespace
+
+void begin() {
+  if (!MC_TTS_CACHE) return;
+  if (!g_mutex) g_mutex = xSemaphoreCreateMutex();
+  Lock_ lock;
+  if (g_ready) return;
+  if (!LittleFS.begin(true)) return;
+  if (!LittleFS.exists(kDir)) LittleFS.mkdir(kDir);
+  g_count = 0;
+  g_total = 0;
+  g_seq = 0;
+  File f = LittleFS.open(kIndexPath, "r");
+  if (f) {
+    JsonDocument doc;
+    const DeserializationError err = deserializeJson(doc, f);
+    f.close();
+    if (!err) {
+      g_seq = doc["seq"] | 0;
+      for (JsonObject o : doc["e"].as<JsonArray>()) {
+        if (g_count >= MC_TTS_CACHE_MAX_ENTRIES) break;
+        const char* k = o["k"] | "";
+        if (strlen(k) != 16) continue;
+        char hi[9];
+        memcpy(hi, k, 8);
+        hi[8] = '\0';
+        Entry e;
+        e.key_ = ((uint64_t)strtoul(hi, nullptr, 16) << 32) | strtoul(k + 8, nullptr, 16);
+        e.bytes_ = o["b"] | 0;
+        e.use_ = o["u"] | 0;
+        // Drop entries whose file is gone or was cut short.
+        char p[40];
+        path_(e.key_, p, sizeof(p));
+        File wav = LittleFS.open(p, "r");
+        const bool ok = wav && wav.size() == e.bytes_ && e.bytes_ > 0;
+        if (wav) wav.close();
+        if (!ok) {
+          LittleFS.remove(p);
+          continue;
+        }
+        g_entries[g_count++] = e;
+        g_total += e.bytes_;
+      }
+    }
+  }
+  // Files the index does not know (e.g. a temp file from a reset mid-write).
+  File dir = LittleFS.open(kDir);
+  if (dir && dir.isDirectory()) {
+    char stale[8][40];
+    size_t nStale = 0;
+    for (File e = dir.openNextFile(); e; e = dir.openNextFile()) {
+      const char* name = strrchr(e.name(), '/');
+      name = name ? name + 1 : e.name();
+      e.close();
+      if (strcmp(name, "index.json") == 0) continue;
+      bool known = false;
+      for (size_t i = 0; i < g_count && !known; ++i) {
+        char p[40];
+        path_(g_entries[i].key_, p, sizeof(p));
+        known = (strcmp(p + strlen(kDir) + 1, name) == 0);
+      }
+      if (!known && nStale < 8) {
+        snprintf(stale[nStale++], sizeof(stale[0]), "%s/%s", kDir, name);
+      }
+    }
+    dir.close();
+    for (size_t i = 0; i < nStale; ++i) LittleFS.remove(stale[i]);
+  }
+  g_ready = true;
+  MC_LOGI("TTS", "cache: %u entries, %luB / %luB",
+          (unsigned)g_count, (unsigned long)g_total,
+          (unsigned long)MC_TTS_CACHE_BUDGET_BYTES);
+}
+
+uint64_t keyFor(const String& ssml, const char* format) {
+  // FNV-1a 64 over SSML, a separator and the output format.
+  uint64_t h = 0xcbf29ce484222325ull;
+  auto mix = [&](const char* s, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      h ^= (uint8_t)s[i];
+      h *= 0x100000001b3ull;
+    }
+  };
+  mix(ssml.c_str(), ssml.length());
+  mix("\n", 1);
+  if (format) mix(format, strlen(format));
+  return h;
+}
+
+bool contains(uint64_t key) {
+  if (!ready_()) return false;
+  Lock_ lock;
+  return find_(key) >= 0;
+}
+
+bool load(uint64_t key, uint8_t** outBuf, size_t* outLen) {
+  *outBuf = nullptr;
+  *outLen = 0;
+  if (!ready_()) return false;
+  Lock_ lock;
+  const int i = find_(key);
+  if (i < 0) return false;
+  char p[40];
+  path_(key, p, sizeof(p));
+  File f = LittleFS.open(p, "r");
+  if (!f) {
+    removeAt_((size_t)i);
+    save_();
+    return false;
+  }
+  const size_t n = f.size();
+  uint8_t* buf = (n > 0) ? payload_arena::acquire(payload_arena::Slot::Net, n) : nullptr;
+  if (!buf && n > 0) buf = (uint8_t*)malloc(n);
+  if (!buf) {
+    f.close();
+    return false;
+  }
+  const size_t got = f.read(buf, n);
+  f.close();
+  if (got != n) {
+    payload_arena::release(buf);
+    removeAt_((size_t)i);
+    save_();
+    return false;
+  }
+  g_entries[i].use_ = ++g_seq;
+  g_dirty = true;
+  if (millis() - g_lastSaveMs >= kSaveEveryMs) save_();
+  *outBuf = buf;
+  *outLen = n;
+  return true;
+}
+
+bool store(uint64_t key, const uint8_t* wav, size_t len) {
+  if (!wav || !len || len > MC_TTS_CACHE_BUDGET_BYTES || !ready_()) return false;
+  Lock_ lock;
+  File f = LittleFS.open(kTmpPath, "w");
+  if (!f) return false;
+  const size_t put = f.write(wav, len);
+  f.close();
+  if (put != len) {
+    LittleFS.remove(kTmpPath);
+    return false;
+  }
+  return adopt_(key, kTmpPath, (uint32_t)len);
+}
+
+bool beginWrite(Writer& w, uint64_t key, uint32_t sampleRate) {
+  w = Writer();
+  if (!ready_()) return false;
+  Lock_ lock;
+  w.f_ = LittleFS.open(kTmpPath, "w");
+  if (!w.f_) return false;
+  uint8_t h[kWavHeaderBytes] = {0};
+  if (w.f_.write(h, sizeof(h)) != sizeof(h)) {
+    w.f_.close();
+    LittleFS.remove(kTmpPath);
+    return false;
+  }
+  w.key_ = key;
+  w.rate_ = sampleRate;
+  w.open_ = true;
+  return true;
+}
+
+bool write(Writer& w, const uint8_t* p, size_t n) {
+  if (!w.open_) return false;
+  if (kWavHeaderBytes + w.bytes_ + n > MC_TTS_CACHE_BUDGET_BYTES ||
+      w.f_.write(p, n) != n) {
+    abort(w);
+    return false;
+  }
+  w.bytes_ += n;
+  return true;
+}
+
+bool commit(Writer& w) {
+  if (!w.open_) return false;
+  Lock_ lock;
+  uint8_t h[kWavHeaderBytes];
+  wavHeader_(h, w.rate_, (uint32_t)w.bytes_);
+  const bool ok = w.bytes_ > 0 && w.f_.seek(0) && w.f_.write(h, sizeof(h)) == sizeof(h);
+  w.f_.close();
+  w.open_ = false;
+  if (!ok) {
+    LittleFS.remove(kTmpPath);
+    return false;
+  }
+  return adopt_(w.key_, kTmpPath, (uint32_t)(kWavHeaderBytes + w.bytes_));
+}
+
+void abort(Writer& w) {
+  if (!w.open_) return;
+  Lock_ lock;
+  w.f_.close();
+  w.open_ = false;
+  LittleFS.remove(kTmpPath);
+}
+} // namespace tts_cache
@@ -0,0 +1,43 @@
+// Module implementation.
+// Content-addressed TTS audio cache on LittleFS (/ttsc/<key>.wav).
+//
+// The key is a hash of the SSML (voice + text) and the output format, so a
+// repeated phrase (share accepted, hello, fallback lines) plays from flash
+// without an Azure round trip - also while offline. Entries are evicted
+// least-recently-used first to stay under MC_TTS_CACHE_BUDGET_BYTES.
+//
+// NOTE:
+// - Thread-safe (speakAsync on the main loop, fetch on the TTS task).
+// - The LRU order lives in RAM; /ttsc/index.json is rewritten on store /
+//   eviction and at most once a minute for hits (flash wear).
+#pragma once
+#include <Arduino.h>
+#include <FS.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace tts_cache {
+// Mount and load the index (idempotent; also done lazily).
+void begin();
+uint64_t keyFor(const String& ssml, const char* format);
+bool contains(uint64_t key);
+// Whole WAV into a payload buffer (caller frees with payload_arena::release()).
+// Counts as a use.
+bool load(uint64_t key, uint8_t** outBuf, size_t* outLen);
+bool store(uint64_t key, const uint8_t* wav, size_t len);
+
+// Incremental store for streamed PCM16 mono: write() appends samples to a
+// temp file behind a 44-byte WAV header that commit() fills in before the
+// rename (abort() or a failed write drops it).
+struct Writer {
+  File f_;
+  uint64_t key_ = 0;
+  uint32_t rate_ = 0;
+  size_t bytes_ = 0;   // PCM bytes
+  bool open_ = false;
+};
+bool beginWrite(Writer& w, uint64_t key, uint32_t sampleRate);
+bool write(Writer& w, const uint8_t* p, size_t n);
+bool commit(Writer& w);
+void abort(Writer& w);
+} // namespace tts_cache
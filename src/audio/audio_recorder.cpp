@@ -21,6 +21,7 @@
 #include <esp_task_wdt.h>
 
 #include "audio/i2s_manager.h"
+#include "audio/payload_arena.h"
 #include "config/config.h"
 #include "utils/logging.h"
 static void forceUninstallI2S_(const char* reason) {
@@ -166,7 +167,13 @@ bool AudioRecorder::allocBuffer_() {
   if (pcm_) return true;
   maxSamples_ = (size_t)sampleRate_ * (size_t)maxSeconds_;
   const size_t bytes = maxSamples_ * sizeof(int16_t);
-  pcm_ = (int16_t*)heap_caps_malloc(bytes, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+  // Arena slot: a WAV header's worth of room in front for the STT upload.
+  uint8_t* slot = payload_arena::acquire(payload_arena::Slot::Rec, 44 + bytes);
+  if (slot) {
+    pcm_ = (int16_t*)(slot + 44);
+  } else {
+    pcm_ = (int16_t*)heap_caps_malloc(bytes, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+  }
   if (!pcm_) {
     pcm_ = (int16_t*)malloc(bytes);
   }
@@ -183,7 +190,7 @@ bool AudioRecorder::allocBuffer_() {
 }
 void AudioRecorder::freeBuffer_() {
   if (pcm_) {
-    free(pcm_);
+    payload_arena::release(pcm_);
     pcm_ = nullptr;
   }
   maxSamples_ = 0;
@@ -0,0 +1,89 @@
+// Module implementation.
+#include "audio/payload_arena.h"
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+#include <atomic>
+
+#include "config/config.h"
+#include "utils/logging.h"
+
+namespace payload_arena {
+namespace {
+static const size_t kSlotBytes[2] = {
+    (size_t)MC_PAYLOAD_ARENA_REC_BYTES,
+    (size_t)MC_PAYLOAD_ARENA_NET_BYTES,
+};
+static uint8_t* g_base = nullptr;
+static bool g_tried = false;
+static std::atomic<bool> g_busy[2];
+
+static uint8_t* slotBase_(uint8_t i) {
+  return g_base + (i ? kSlotBytes[0] : 0);
+}
+// Slot index of p, or -1.
+static int slotOf_(const void* p) {
+  if (!g_base || !p) return -1;
+  const uint8_t* b = (const uint8_t*)p;
+  for (uint8_t i = 0; i < 2; ++i) {
+    const uint8_t* s = slotBase_(i);
+    if (b >= s && b < s + kSlotBytes[i]) return i;
+  }
+  return -1;
+}
+} // namespace
+
+bool begin() {
+  if (g_base) return true;
+  if (!MC_PAYLOAD_ARENA || g_tried) return false;
+  g_tried = true;
+  if (!psramFound()) {
+    MC_LOGI("MEM", "payload arena: no PSRAM -> heap buffers");
+    return false;
+  }
+  const size_t total = kSlotBytes[0] + kSlotBytes[1];
+  g_base = (uint8_t*)heap_caps_malloc(total, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+  if (!g_base) {
+    MC_LOGW("MEM", "payload arena: alloc %uB failed -> heap buffers", (unsigned)total);
+    return false;
+  }
+  g_busy[0] = false;
+  g_busy[1] = false;
+  MC_LOGI("MEM", "payload arena: rec=%uB net=%uB (PSRAM)",
+          (unsigned)kSlotBytes[0], (unsigned)kSlotBytes[1]);
+  return true;
+}
+
+uint8_t* acquire(Slot s, size_t minBytes, size_t* outCap) {
+  if (outCap) *outCap = 0;
+  const uint8_t i = (uint8_t)s & 1;
+  if (!begin() || minBytes > kSlotBytes[i]) return nullptr;
+  bool expected = false;
+  if (!g_busy[i].compare_exchange_strong(expected, true)) {
+    MC_LOGD("MEM", "payload arena: slot %u busy -> heap", (unsigned)i);
+    return nullptr;
+  }
+  if (outCap) *outCap = kSlotBytes[i];
+  return slotBase_(i);
+}
+
+void release(void* p) {
+  if (!p) return;
+  const int i = slotOf_(p);
+  if (i < 0) {
+    free(p);
+    return;
+  }
+  g_busy[i] = false;
+}
+
+bool owns(const void* p) {
+  return slotOf_(p) >= 0;
+}
+
+size_t headroom(const void* p) {
+  const int i = slotOf_(p);
+  return (i < 0) ? 0 : (size_t)((const uint8_t*)p - slotBase_((uint8_t)i));
+}
+} // namespace payload_arena
@@ -0,0 +1,30 @@
+// Module implementation.
+// Long-lived audio payload arena (PSRAM) shared by the talk pipeline.
+//
+// One block is reserved at boot and split into fixed slots, so a talk cycle
+// (record -> STT upload -> TTS fetch -> play) does not allocate large
+// buffers from the general heap:
+// - Rec: recorder PCM, with a WAV header's worth of room in front so STT can
+//   upload it without a copy (see headroom()).
+// - Net: one HTTP audio body (TTS fetch / cache load, or an STT copy).
+//
+// NOTE:
+// - Each slot has one owner at a time; acquire() returns nullptr when the
+//   slot is taken, too small, or there is no PSRAM. Callers then fall back
+//   to the heap, and release() frees either kind of pointer.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace payload_arena {
+enum class Slot : uint8_t { Rec = 0, Net = 1 };
+// Reserve the block (idempotent; also done on first acquire()).
+bool begin();
+// Whole slot for the caller until release(); *outCap = usable bytes.
+uint8_t* acquire(Slot s, size_t minBytes, size_t* outCap = nullptr);
+// p from acquire() (any address inside the slot) or from malloc().
+void release(void* p);
+bool owns(const void* p);
+// Bytes of the same slot in front of p (0 if p is not in the arena).
+size_t headroom(const void* p);
+} // namespace payload_arena
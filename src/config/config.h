@@ -53,9 +53,45 @@
 #ifndef MC_AI_TEXT_FALLBACK
   #define MC_AI_TEXT_FALLBACK "わかりません" // ai_talk_controller.cpp: STT/LLM失敗時の代替返答
 #endif
+#ifndef MC_TTS_STREAM
+  #define MC_TTS_STREAM 1 // azure_tts.cpp: 1=受信しながら再生（RIFFヘッダ解析後にPCMブロックをスピーカーへ）
+#endif
+#ifndef MC_TTS_STREAM_BLOCK_BYTES
+  #define MC_TTS_STREAM_BLOCK_BYTES 4096 // azure_tts.cpp: ストリーム再生の1ブロック(bytes, 偶数)
+#endif
+#ifndef MC_TTS_STREAM_BLOCKS
+  #define MC_TTS_STREAM_BLOCKS 8 // azure_tts.cpp: ストリーム再生のリングブロック数（16kHzで4096x8≒1秒）
+#endif
+#ifndef MC_TTS_SEGMENTS
+  #define MC_TTS_SEGMENTS 6 // azure_tts.cpp: 文単位で分割して先読み合成する最大セグメント数（1=分割しない, ストリーム時のみ）
+#endif
+#ifndef MC_TTS_SEGMENT_MIN_BYTES
+  #define MC_TTS_SEGMENT_MIN_BYTES 24 // azure_tts.cpp: これより短い文は前後とまとめて1セグメントにする
+#endif
+#ifndef MC_TTS_CACHE
+  #define MC_TTS_CACHE 1 // tts_cache.cpp: 1=合成済みWAVをLittleFS(/ttsc)にキャッシュ
+#endif
+#ifndef MC_TTS_CACHE_BUDGET_BYTES
+  #define MC_TTS_CACHE_BUDGET_BYTES (512UL * 1024UL) // tts_cache.cpp: キャッシュ合計上限(bytes, LRUで追い出し)
+#endif
+#ifndef MC_TTS_CACHE_MAX_ENTRIES
+  #define MC_TTS_CACHE_MAX_ENTRIES 24 // tts_cache.cpp: キャッシュ件数上限
+#endif
+#ifndef MC_TTS_CACHE_MAX_TEXT_BYTES
+  #define MC_TTS_CACHE_MAX_TEXT_BYTES 96 // azure_tts.cpp: これ以下の短い文だけキャッシュ対象
+#endif
 #ifndef MC_AZ_TTS_VOICE
   #define MC_AZ_TTS_VOICE "ja-JP-AoiNeural" // azure_tts.cpp: defaultVoice_として使用
 #endif
+#ifndef MC_AZ_TOKEN_TTL_MS
+  #define MC_AZ_TOKEN_TTL_MS (9UL * 60UL * 1000UL) // azure_token.cpp: STSトークンの使用期限(ms, Azure側は10分)
+#endif
+#ifndef MC_AZ_TOKEN_REFRESH_MS
+  #define MC_AZ_TOKEN_REFRESH_MS (8UL * 60UL * 1000UL) // azure_token.cpp: 取得後この時間でバックグラウンド更新(ms, TTL未満)
+#endif
+#ifndef MC_AZ_TOKEN_IDLE_MS
+  #define MC_AZ_TOKEN_IDLE_MS (15UL * 60UL * 1000UL) // azure_token.cpp: この時間get()が無ければ更新を止める(ms, 次のget()で再開)
+#endif
 #ifndef MC_OPENAI_INSTRUCTIONS
   // openai_llm.cpp: req["instructions"] にそのまま入る初期指示
   #define MC_OPENAI_INSTRUCTIONS \
@@ -68,6 +104,80 @@
 #ifndef MC_CPU_FREQ_MHZ
   #define MC_CPU_FREQ_MHZ 240 // main.cpp: setCpuFrequencyMhzの要求値
 #endif
+#ifndef MC_DUCO_COOP
+  #define MC_DUCO_COOP 0 // mining_task.cpp: 1=T0の1接続のジョブを全コアでnonce分割（T1以降は接続しない）
+#endif
+#ifndef MC_DUCO_MAX_THREADS
+  #define MC_DUCO_MAX_THREADS 4 // mining_task.cpp: マイナータスク数の上限（実際の数は mc_config_store の miner_threads）
+#endif
+#ifndef MC_DUCO_THREADS
+  #define MC_DUCO_THREADS 2 // mc_config_store.cpp: miner_threads の既定値
+#endif
+#ifndef MC_DUCO_MINER_CORES
+  #define MC_DUCO_MINER_CORES "01" // mc_config_store.cpp: miner_cores の既定値（i番目のタスクのコア: 0/1/x=指定なし, 足りない分は繰り返し）
+#endif
+#ifndef MC_DUCO_MINER_PRIO
+  #define MC_DUCO_MINER_PRIO 1 // mc_config_store.cpp: miner_prio の既定値（DucoNetタスクはこれ+1）
+#endif
+#ifndef MC_DUCO_MINER_STACK
+  #define MC_DUCO_MINER_STACK 8192 // mc_config_store.cpp: miner_stack の既定値(bytes)
+#endif
+#ifndef MC_DUCO_MEASURE
+  #define MC_DUCO_MEASURE 0 // mc_config_store.cpp: miner_measure の既定値（1=コア別/タスク別ハッシュレートを定期ログ）
+#endif
+#ifndef MC_DUCO_MEASURE_MS
+  #define MC_DUCO_MEASURE_MS 30000 // mining_task.cpp: コア別ハッシュレートの集計窓(ms)
+#endif
+#ifndef MC_DUCO_SOLVER
+  #define MC_DUCO_SOLVER 1 // mining_task.cpp: 0=mbedtls / 1=midstate / 3,4=multilane（レーン数, mining_solver::SolverKind。2はmidstate扱い）
+#endif
+#ifndef MC_DUCO_POOL_URL
+  #define MC_DUCO_POOL_URL "https://server.duinocoin.com/getPool" // mining_task.cpp: getPool URL（http://はローカルエミュレータ用に平文）
+#endif
+#ifndef MC_MINING_YIELD_AUTOTUNE
+  #define MC_MINING_YIELD_AUTOTUNE 1 // mining_task.cpp: 1=通常プロファイル中はyield間隔/遅延を自動調整
+#endif
+#ifndef MC_MINING_YIELD_LOOP_LATE_US
+  #define MC_MINING_YIELD_LOOP_LATE_US 4000 // mining_task.cpp: メインループ起床遅れの許容上限(us, 窓内最大)
+#endif
+#ifndef MC_MINING_YIELD_FRAME_US
+  #define MC_MINING_YIELD_FRAME_US 50000 // mining_task.cpp: UI 1フレーム描画時間の許容上限(us, 窓内最大)
+#endif
+#ifndef MC_GOV_ENABLE
+  #define MC_GOV_ENABLE 1 // mining_governor.cpp: 1=温度/電源に応じてマイニングを絞る
+#endif
+#ifndef MC_GOV_PERIOD_MS
+  #define MC_GOV_PERIOD_MS 5000 // mining_governor.cpp: 温度/バッテリーのサンプリング周期
+#endif
+#ifndef MC_GOV_TEMP_TARGET_C
+  #define MC_GOV_TEMP_TARGET_C 65 // mining_governor.cpp: この温度以上で1段ずつ絞る
+#endif
+#ifndef MC_GOV_TEMP_HYST_C
+  #define MC_GOV_TEMP_HYST_C 5 // mining_governor.cpp: 目標-この値以下で1段戻す
+#endif
+#ifndef MC_GOV_RELAX_MS
+  #define MC_GOV_RELAX_MS 30000 // mining_governor.cpp: 段を戻すまでの最短間隔
+#endif
+#ifndef MC_GOV_BATT_LEVEL
+  #define MC_GOV_BATT_LEVEL 0 // mining_governor.cpp: バッテリー駆動中の最低レベル(0..4, 0=絞らない)
+#endif
+#ifndef MC_GOV_BATT_LOW_PCT
+  #define MC_GOV_BATT_LOW_PCT 0 // mining_governor.cpp: 残量がこれ未満ならレベル3以上(0=無効, 例:30)
+#endif
+#ifndef MC_GOV_BATT_CRIT_PCT
+  #define MC_GOV_BATT_CRIT_PCT 0 // mining_governor.cpp: 残量がこれ未満ならマイニング停止(レベル4, 0=無効, 例:10)
+#endif
+// mining_governor.cpp: レベル1..3の上限 {スレッド数(255=全部), CPU MHz, yield間隔(0=制限なし), yield ms}
+// レベル0=設定どおり全速, レベル4=停止 は固定
+#ifndef MC_GOV_STEP1
+  #define MC_GOV_STEP1 {255, 240, 256, 1} // mining_governor.cpp: yieldを増やす
+#endif
+#ifndef MC_GOV_STEP2
+  #define MC_GOV_STEP2 {1, 160, 1024, 1} // mining_governor.cpp: 1ワーカー + クロック低下
+#endif
+#ifndef MC_GOV_STEP3
+  #define MC_GOV_STEP3 {1, 80, 128, 2} // mining_governor.cpp: 最小限のハッシュ
+#endif
 // ---------------------------------------------------------
 // ===== AI TALK (Lv2) : fixed constants (touch/time/limits) =====
 // ---------------------------------------------------------
@@ -89,6 +199,26 @@
 #ifndef MC_AI_REC_SAMPLE_RATE
   #define MC_AI_REC_SAMPLE_RATE 16000 // audio_recorder.cpp/ai_talk_controller.cpp: 録音サンプルレート
 #endif
+// ---- Payload arena (PSRAM) ----
+#ifndef MC_PAYLOAD_ARENA
+  #define MC_PAYLOAD_ARENA 1 // payload_arena.cpp: 1=録音/TTS/STTの大きいバッファをPSRAMの固定領域から取る
+#endif
+#ifndef MC_PAYLOAD_ARENA_REC_BYTES
+  #define MC_PAYLOAD_ARENA_REC_BYTES (44UL + (uint32_t)MC_AI_REC_SAMPLE_RATE * MC_AI_LISTEN_MAX_SECONDS * 2UL) // payload_arena.cpp: 録音スロット(WAVヘッダ+PCM16)
+#endif
+#ifndef MC_PAYLOAD_ARENA_NET_BYTES
+  #define MC_PAYLOAD_ARENA_NET_BYTES (512UL * 1024UL) // payload_arena.cpp: 受信/送信ボディ用スロット(TTSの最大WAVサイズ)
+#endif
+// ---- HTTPS connection pool ----
+#ifndef MC_HTTPS_POOL_SLOTS
+  #define MC_HTTPS_POOL_SLOTS 3 // https_pool.cpp: ホストごとに保持するTLS接続の数（0=毎回新規接続）
+#endif
+#ifndef MC_HTTPS_POOL_IDLE_MS
+  #define MC_HTTPS_POOL_IDLE_MS 45000 // https_pool.cpp: これ以上使われていない接続は再利用せず閉じる(ms)
+#endif
+#ifndef MC_HTTPS_POOL_MIN_HEAP
+  #define MC_HTTPS_POOL_MIN_HEAP 40000 // https_pool.cpp: 返却時の最大確保可能ヒープがこれ未満なら接続を閉じる(bytes)
+#endif
 // ---- Cooldown ----
 #ifndef MC_AI_COOLDOWN_MS
   #define MC_AI_COOLDOWN_MS 2000 // ai_talk_controller.cpp: Cooldown基本時間
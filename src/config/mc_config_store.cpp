@@ -47,10 +47,27 @@ struct RuntimeCfg {
   uint8_t spkVolume_ = (uint8_t)MC_SPK_VOLUME; // 0-255
   String speechShareAccepted_;
   String speechHello_;
+  uint8_t minerThreads_ = (uint8_t)MC_DUCO_THREADS;
+  String minerCores_;
+  uint8_t minerPrio_ = (uint8_t)MC_DUCO_MINER_PRIO;
+  uint32_t minerStack_ = (uint32_t)MC_DUCO_MINER_STACK;
+  bool minerMeasure_ = (MC_DUCO_MEASURE != 0);
 };
 static RuntimeCfg g_rt;
 static bool g_loaded = false;
 static bool g_dirty  = false;
+// Miner topology limits.
+static const uint8_t  kMinerPrioMax = 5;
+static const uint32_t kMinerStackMin = 4096;
+static const uint32_t kMinerStackMax = 32768;
+static bool validCores_(const String& s) {
+  if (!s.length() || s.length() > MC_DUCO_MAX_THREADS) return false;
+  for (size_t i = 0; i < s.length(); ++i) {
+    const char c = s[i];
+    if (c != '0' && c != '1' && c != 'x') return false;
+  }
+  return true;
+}
 static bool isAllQuestionMarks_(const String& s) {
   if (!s.length()) return false;
   for (size_t i = 0; i < s.length(); ++i) {
@@ -75,6 +92,24 @@ static void applyDefaults_() {
   g_rt.spkVolume_      = (uint8_t)MC_SPK_VOLUME;
   g_rt.speechShareAccepted_ = MC_SPEECH_SHARE_ACCEPTED;
   g_rt.speechHello_          = MC_SPEECH_HELLO;
+  g_rt.minerThreads_ = (uint8_t)MC_DUCO_THREADS;
+  g_rt.minerCores_   = MC_DUCO_MINER_CORES;
+  g_rt.minerPrio_    = (uint8_t)MC_DUCO_MINER_PRIO;
+  g_rt.minerStack_   = (uint32_t)MC_DUCO_MINER_STACK;
+  g_rt.minerMeasure_ = (MC_DUCO_MEASURE != 0);
+}
+// Out-of-range values in the file fall back to the defaults.
+static void sanitizeMiner_() {
+  if (g_rt.minerThreads_ < 1 || g_rt.minerThreads_ > MC_DUCO_MAX_THREADS) {
+    g_rt.minerThreads_ = (uint8_t)MC_DUCO_THREADS;
+  }
+  if (!validCores_(g_rt.minerCores_)) g_rt.minerCores_ = MC_DUCO_MINER_CORES;
+  if (g_rt.minerPrio_ < 1 || g_rt.minerPrio_ > kMinerPrioMax) {
+    g_rt.minerPrio_ = (uint8_t)MC_DUCO_MINER_PRIO;
+  }
+  if (g_rt.minerStack_ < kMinerStackMin || g_rt.minerStack_ > kMinerStackMax) {
+    g_rt.minerStack_ = (uint32_t)MC_DUCO_MINER_STACK;
+  }
 }
 static void loadOnce_() {
   if (g_loaded) return;
@@ -152,6 +187,12 @@ static void loadOnce_() {
   setU8("spk_volume",       g_rt.spkVolume_);
   setStr("share_accepted_text", g_rt.speechShareAccepted_);
   setStr("hello_text",          g_rt.speechHello_);
+  setU8("miner_threads", g_rt.minerThreads_);
+  setStr("miner_cores",   g_rt.minerCores_);
+  setU8("miner_prio",     g_rt.minerPrio_);
+  setU32("miner_stack",   g_rt.minerStack_);
+  if (!doc["miner_measure"].isNull()) g_rt.minerMeasure_ = doc["miner_measure"].as<bool>();
+  sanitizeMiner_();
   if (isAllQuestionMarks_(g_rt.speechShareAccepted_)) {
     g_rt.speechShareAccepted_ = MC_SPEECH_SHARE_ACCEPTED;
   }
@@ -233,6 +274,57 @@ bool mcConfigSetKV(const String& key, const String& value, String& err) {
     setDirty();
     return true;
   }
+  if (key == "miner_threads") {
+    char* endp = nullptr;
+    long v = strtol(value.c_str(), &endp, 10);
+    if (endp == value.c_str() || v < 1 || v > MC_DUCO_MAX_THREADS) {
+      err = "range(1-" + String(MC_DUCO_MAX_THREADS) + ")";
+      return false;
+    }
+    g_rt.minerThreads_ = (uint8_t)v;
+    setDirty();
+    return true;
+  }
+  if (key == "miner_cores") {
+    if (!validCores_(value)) {
+      err = "format(0|1|x per task)";
+      return false;
+    }
+    g_rt.minerCores_ = value;
+    setDirty();
+    return true;
+  }
+  if (key == "miner_prio") {
+    char* endp = nullptr;
+    long v = strtol(value.c_str(), &endp, 10);
+    if (endp == value.c_str() || v < 1 || v > kMinerPrioMax) {
+      err = "range(1-" + String(kMinerPrioMax) + ")";
+      return false;
+    }
+    g_rt.minerPrio_ = (uint8_t)v;
+    setDirty();
+    return true;
+  }
+  if (key == "miner_stack") {
+    char* endp = nullptr;
+    long v = strtol(value.c_str(), &endp, 10);
+    if (endp == value.c_str() || v < (long)kMinerStackMin || v > (long)kMinerStackMax) {
+      err = "range(" + String(kMinerStackMin) + "-" + String(kMinerStackMax) + ")";
+      return false;
+    }
+    g_rt.minerStack_ = (uint32_t)v;
+    setDirty();
+    return true;
+  }
+  if (key == "miner_measure") {
+    if (value != "0" && value != "1") {
+      err = "range(0|1)";
+      return false;
+    }
+    g_rt.minerMeasure_ = (value == "1");
+    setDirty();
+    return true;
+  }
   err = "unknown_key";
   return false;
 }
@@ -259,6 +351,11 @@ bool mcConfigSave(String& err) {
   doc["spk_volume"]      = g_rt.spkVolume_;
   doc["share_accepted_text"] = g_rt.speechShareAccepted_;
   doc["hello_text"]          = g_rt.speechHello_;
+  doc["miner_threads"] = g_rt.minerThreads_;
+  doc["miner_cores"]   = g_rt.minerCores_;
+  doc["miner_prio"]    = g_rt.minerPrio_;
+  doc["miner_stack"]   = g_rt.minerStack_;
+  doc["miner_measure"] = g_rt.minerMeasure_;
   File f = LittleFS.open(kCfgPath, "w");
   if (!f) {
     err = "open_failed";
@@ -307,6 +404,11 @@ String mcConfigGetMaskedJson() {
   doc["spk_volume"]      = g_rt.spkVolume_;
   doc["share_accepted_text"] = g_rt.speechShareAccepted_;
   doc["hello_text"]          = g_rt.speechHello_;
+  doc["miner_threads"] = g_rt.minerThreads_;
+  doc["miner_cores"]   = g_rt.minerCores_;
+  doc["miner_prio"]    = g_rt.minerPrio_;
+  doc["miner_stack"]   = g_rt.minerStack_;
+  doc["miner_measure"] = g_rt.minerMeasure_;
   String out;
   serializeJson(doc, out);
   return out;
@@ -326,3 +428,8 @@ uint8_t mcCfgSpkVolume()         { loadOnce_(); return g_rt.spkVolume_; }
 const char* mcCfgShareAcceptedText() { loadOnce_(); return g_rt.speechShareAccepted_.c_str(); }
 const char* mcCfgHelloText()         { loadOnce_(); return g_rt.speechHello_.c_str(); }
 uint32_t mcCfgCpuMhz() { loadOnce_(); return (uint32_t)g_rt.cpuMhz_; }
+uint8_t mcCfgMinerThreads()     { loadOnce_(); return g_rt.minerThreads_; }
+const char* mcCfgMinerCores()   { loadOnce_(); return g_rt.minerCores_.c_str(); }
+uint8_t mcCfgMinerPrio()        { loadOnce_(); return g_rt.minerPrio_; }
+uint32_t mcCfgMinerStack()      { loadOnce_(); return g_rt.minerStack_; }
+bool mcCfgMinerMeasure()        { loadOnce_(); return g_rt.minerMeasure_; }
@@ -17,6 +17,12 @@ uint8_t mcCfgSpkVolume();
 const char* mcCfgShareAcceptedText();
 const char* mcCfgHelloText();
 uint32_t mcCfgCpuMhz();
+// Miner topology (read by startMiner(); changes apply after a reboot).
+uint8_t mcCfgMinerThreads();
+const char* mcCfgMinerCores();   // per task: '0' / '1' / 'x' (any core)
+uint8_t mcCfgMinerPrio();
+uint32_t mcCfgMinerStack();
+bool mcCfgMinerMeasure();        // per-core hashrate log (applies at once)
 
 // Config edit helpers
 void mcConfigBegin();
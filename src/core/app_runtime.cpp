@@ -585,11 +585,13 @@ void appRuntimeTick(uint32_t now) {
       }
     }
     String ticker = buildTicker(summary);
+    const uint32_t frameStartUs = micros();
     if (g_mode == Stackchan) {
       ui.drawStackchanScreen(data);
     } else {
       ui.drawAll(data, ticker);
     }
+    if (!g_displaySleeping) noteMiningUiFrameUs(micros() - frameStartUs);
     g_suppressTouchBeepOnce = false;
   }
 
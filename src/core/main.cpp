@@ -24,6 +24,7 @@
 #include "config/config.h"
 #include "core/public/app_runtime.h"
 #include "core/orchestrator.h"
+#include "core/public/mining_governor.h"
 #include "core/public/serial_setup.h"
 #include "core/public/tts_coordinator.h"
 #include "ui/ui_mining_core2.h"
@@ -98,6 +99,7 @@ void setup() {
   );
   mc_logf("%s %s booting...", cfg.appName_, cfg.appVersion_);
   startMiner();
+  miningGovernorInit();
 }
 void loop() {
   M5.update();
@@ -105,5 +107,10 @@ void loop() {
   pollSetupSerial();
   const uint32_t now = (uint32_t)millis();
   appRuntimeTick(now);
+  miningGovernorTick(now);
+  // Oversleep past the 2 ms delay = time the miners kept this core.
+  const uint32_t sleepUs = micros();
   delay(2);
+  const uint32_t sleptUs = micros() - sleepUs;
+  noteMiningLoopLateUs(sleptUs > 2000 ? sleptUs - 2000 : 0);
 }
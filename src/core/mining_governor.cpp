@@ -0,0 +1,121 @@
+// Module implementation.
+#include "core/public/mining_governor.h"
+
+#include <Arduino.h>
+#include <esp32-hal-cpu.h>
+
+#include "ai/mining_task.h"
+#include "config/config.h"
+#include "config/mc_config_store.h"
+#include "ui/ui_mining_core2.h"
+#include "utils/logging.h"
+#include "utils/mining_summary.h"
+
+namespace {
+// One row per level; threads / MHz are caps on the configured values.
+// Levels 1..3 come from MC_GOV_STEP1..3 (config.h).
+struct GovStep {
+  uint8_t  threads_;   // 255 = all configured workers
+  uint16_t cpuMhz_;
+  uint16_t yieldEvery_;  // 0 = no yield limit
+  uint8_t  yieldMs_;
+};
+static const GovStep kSteps[] = {
+  {255, 240, 0,    0},  // 0: full speed
+  MC_GOV_STEP1,         // 1: more yields
+  MC_GOV_STEP2,         // 2: one worker, slower clock
+  MC_GOV_STEP3,         // 3: minimal hashing
+  {0,   80,  0,    0},  // 4: mining stopped
+};
+static const uint8_t kMaxLevel = sizeof(kSteps) / sizeof(kSteps[0]) - 1;
+} // namespace
+
+static uint8_t  g_fullThreads = 0;
+static uint8_t  g_thermalLevel = 0;
+static uint8_t  g_level = 0;
+static uint32_t g_lastSampleMs = 0;
+static uint32_t g_lastThermalChangeMs = 0;
+static MiningGovernorState g_state;
+
+// Opt-in: with the MC_GOV_BATT_* defaults (0) battery power changes nothing.
+static uint8_t batteryFloor_(bool ext, int pct, const char** reason) {
+  if (ext) return 0;
+  if (pct >= 0 && pct < MC_GOV_BATT_CRIT_PCT) {
+    *reason = "batt_crit";
+    return kMaxLevel;
+  }
+  if (pct >= 0 && pct < MC_GOV_BATT_LOW_PCT) {
+    *reason = "batt_low";
+    return 3;
+  }
+  if (MC_GOV_BATT_LEVEL == 0) return 0;
+  *reason = "batt";
+  return (MC_GOV_BATT_LEVEL > kMaxLevel) ? kMaxLevel : (uint8_t)MC_GOV_BATT_LEVEL;
+}
+
+static void applyLevel_(uint8_t level) {
+  const GovStep& st = kSteps[level];
+  const uint8_t threads = (st.threads_ == 255 || st.threads_ > g_fullThreads)
+                              ? g_fullThreads : st.threads_;
+  uint32_t mhz = mcCfgCpuMhz();
+  if (mhz > st.cpuMhz_) mhz = st.cpuMhz_;
+  setMiningActiveThreads(threads);
+  setMiningYieldLimit(MiningYieldProfile(st.yieldEvery_, st.yieldMs_));
+  if ((uint32_t)getCpuFrequencyMhz() != mhz) setCpuFrequencyMhz((int)mhz);
+  g_state.threads_ = threads;
+  g_state.cpuMhz_ = (uint16_t)getCpuFrequencyMhz();
+}
+
+void miningGovernorInit() {
+  g_fullThreads = getMiningActiveThreads();
+  g_state = MiningGovernorState();
+  g_state.threads_ = g_fullThreads;
+  g_state.cpuMhz_ = (uint16_t)getCpuFrequencyMhz();
+  g_state.reason_ = MC_GOV_ENABLE ? "ok" : "off";
+  setMiningGovernorState(g_state);
+}
+
+void miningGovernorTick(uint32_t now) {
+  if (!MC_GOV_ENABLE) return;
+  if (g_lastSampleMs != 0 && (uint32_t)(now - g_lastSampleMs) < MC_GOV_PERIOD_MS) return;
+  g_lastSampleMs = now ? now : 1;
+  UIMining& ui = UIMining::instance();
+  const float t = ui.readTempC();
+  const int pct = ui.batteryPct();
+  const bool ext = ui.isExternalPower();
+  // Thermal: one step per sample above target; back off one step only after
+  // a calm spell below target - hysteresis. readTempC() gives 0 when unknown.
+  if (t > 0.0f) {
+    if (t >= (float)MC_GOV_TEMP_TARGET_C) {
+      if (g_thermalLevel < kMaxLevel) {
+        ++g_thermalLevel;
+        g_lastThermalChangeMs = now;
+      }
+    } else if (g_thermalLevel > 0 &&
+               t <= (float)(MC_GOV_TEMP_TARGET_C - MC_GOV_TEMP_HYST_C) &&
+               (uint32_t)(now - g_lastThermalChangeMs) >= MC_GOV_RELAX_MS) {
+      --g_thermalLevel;
+      g_lastThermalChangeMs = now;
+    }
+  }
+  const char* battReason = "ok";
+  const uint8_t battLevel = batteryFloor_(ext, pct, &battReason);
+  const uint8_t level = (g_thermalLevel > battLevel) ? g_thermalLevel : battLevel;
+  const char* reason = (level == 0) ? "ok"
+                     : (g_thermalLevel >= battLevel) ? "temp" : battReason;
+  if (level != g_level) {
+    MC_EVT("GOV", "level %u -> %u (%s) t=%.1fC batt=%d%% %s",
+           (unsigned)g_level, (unsigned)level, reason, t, pct, ext ? "AC" : "BAT");
+    g_level = level;
+    applyLevel_(level);
+    MC_LOGI("GOV", "threads=%u cpu=%uMHz yield_limit=%u/%ums",
+            (unsigned)g_state.threads_, (unsigned)g_state.cpuMhz_,
+            (unsigned)kSteps[level].yieldEvery_, (unsigned)kSteps[level].yieldMs_);
+  }
+  g_state.level_ = g_level;
+  g_state.reason_ = reason;
+  g_state.tempC_ = t;
+  g_state.battPct_ = pct;
+  g_state.extPower_ = ext;
+  setMiningGovernorState(g_state);
+}
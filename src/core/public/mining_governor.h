@@ -0,0 +1,11 @@
+// Module implementation.
+// Thermal / battery governor for the miner: picks a throttle level from chip
+// temperature and power source, and applies it to worker threads, the yield
+// limit and the CPU clock. Level 0 = full speed (as configured).
+#pragma once
+#include <stdint.h>
+
+void miningGovernorInit();
+// UI loop task (sensors share the I2C bus with the UI); samples every
+// MC_GOV_PERIOD_MS.
+void miningGovernorTick(uint32_t now);
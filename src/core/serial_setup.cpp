@@ -18,6 +18,7 @@
 #include "config/mc_config_store.h"
 #include "config/runtime_features.h"
 #include "ui/ui_mining_core2.h"
+#include "utils/https_pool.h"
 #include "utils/logging.h"
 
 static SerialSetupContext g_ctx;
@@ -40,7 +41,7 @@ static void handleSetupLine_(const char* line) {
     return;
   }
   if (cmd.equalsIgnoreCase("HELP")) {
-    Serial.println("@OK CMDS=HELLO,PING,GET INFO,HELP");
+    Serial.println("@OK CMDS=HELLO,PING,GET INFO,GET NET,HELP");
     return;
   }
   if (cmd.equalsIgnoreCase("GET INFO")) {
@@ -52,6 +53,17 @@ static void handleSetupLine_(const char* line) {
     Serial.println(buf);
     return;
   }
+  if (cmd.equalsIgnoreCase("GET NET")) {
+    // Warm HTTPS pool: new handshakes vs kept-alive reuses since boot.
+    const https_pool::Stats st = https_pool::stats();
+    char buf[96];
+    snprintf(buf, sizeof(buf),
+             "@NET {\"handshakes\":%lu,\"reuses\":%lu,\"stale\":%lu}",
+             (unsigned long)st.handshakes_, (unsigned long)st.reuses_,
+             (unsigned long)st.stale_);
+    Serial.println(buf);
+    return;
+  }
   if (cmd.equalsIgnoreCase("GET CFG")) {
     String j = mcConfigGetMaskedJson();
     Serial.print("@CFG ");
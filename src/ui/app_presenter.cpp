@@ -13,6 +13,17 @@ String buildTicker(const MiningSummary &s) {
       t += "|";
       t += String(s.workNonce_);
     }
+    if (s.totalKh_ > 0.0f) {
+      t += "|";
+      t += String(s.totalKh_, 1);
+      t += "kH/s ";
+      t += String(s.khMin1m_, 1);
+      t += "-";
+      t += String(s.khMax1m_, 1);
+      t += "|";
+      t += String(s.sharesPerMin_, 1);
+      t += "/min";
+    }
     return t;
   }
   t = s.logLine40_;
@@ -36,6 +47,7 @@ void buildPanelData(const MiningSummary &summary, UIMining &ui,
   data.diff_ = (float)summary.maxDifficulty_;
   data.pingMs_ = summary.maxPingMs_;
   data.miningEnabled_ = summary.miningEnabled_;
+  data.govLevel_ = summary.gov_.level_;
   data.elapsedS_ = ui.uptimeSeconds();
   data.sw_ = cfg.appVersion_;
   data.fw_ = ui.shortFwString();
@@ -68,6 +68,10 @@ public:
   void setStackchanSpeech(const String& text);
   void setStackchanExpression(m5avatar::Expression exp);
   void setAiOverlay(const AiUiOverlay& ov);
+  // Sensors (DEVICE page, mining governor). UI loop task only (I2C).
+  float   readTempC();
+  int     batteryPct();
+  bool    isExternalPower();
 private:
 private:
   AiUiOverlay aiOverlay_{};
@@ -191,9 +195,6 @@ private:
   uint16_t cRssi(int rssi) const;
   uint16_t cBatt(int pct) const;
   // ---------- Temperature / Power ----------
-  float   readTempC();
-  int     batteryPct();
-  bool    isExternalPower();
   String  vBatt();
   // ---------- Pages ----------
   void drawPage0(const PanelData& p);
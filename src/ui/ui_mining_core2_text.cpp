@@ -268,7 +268,14 @@ void UIMining::drawPage1(const PanelData& p) {
   drawHeader("DEVICE STATUS", ly);
   drawLine(ly.y1, "UP  ", vUp(p.elapsedS_), kColLabel, WHITE);
   float tc = readTempC();
-  drawLine(ly.y2, "TEMP", vTemp(tc), kColLabel, cTemp(tc));
+  String tv = vTemp(tc);
+  if (p.govLevel_) {
+    // Governor is throttling mining: " 68 C G2".
+    char g[8];
+    snprintf(g, sizeof(g), " G%u", (unsigned)p.govLevel_);
+    tv += g;
+  }
+  drawLine(ly.y2, "TEMP", tv, kColLabel, cTemp(tc));
   int pct = batteryPct();
   drawLine(ly.y3, "BATT", vBatt(), kColLabel, cBatt(pct));
   uint32_t freeKb = ESP.getFreeHeap() / 1024;
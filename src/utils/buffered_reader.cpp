@@ -0,0 +1,84 @@
+// Module implementation.
+#include "utils/buffered_reader.h"
+
+#include <string.h>
+
+int BufferedReader::available() {
+  const int a = c_ ? c_->available() : 0;
+  return (int)(len_ - pos_) + (a > 0 ? a : 0);
+}
+
+int BufferedReader::wait_(uint32_t idleMs, const std::atomic<bool>* abort) {
+  if (!c_) return 0;
+  const uint32_t t0 = millis();
+  while (true) {
+    if (abort && abort->load()) return -1;
+    const int a = c_->available();
+    if (a > 0) return a;
+    if (!c_->connected()) return 0;
+    if (millis() - t0 > idleMs) return -1;
+    delay(1);
+  }
+}
+
+int BufferedReader::readSome(uint8_t* dst, size_t n, uint32_t idleMs,
+                             const std::atomic<bool>* abort) {
+  if (n == 0) return 0;
+  if (pos_ < len_) {
+    const size_t take = (len_ - pos_ < n) ? len_ - pos_ : n;
+    memcpy(dst, buf_ + pos_, take);
+    pos_ += take;
+    return (int)take;
+  }
+  const int a = wait_(idleMs, abort);
+  if (a <= 0) return a;
+  // Large reads go straight to the caller; small ones refill the buffer.
+  if (n >= kBufBytes) {
+    const int r = c_->read(dst, ((size_t)a < n) ? (size_t)a : n);
+    return (r > 0) ? r : -1;
+  }
+  const int r = c_->read(buf_, ((size_t)a < kBufBytes) ? (size_t)a : kBufBytes);
+  if (r <= 0) return -1;
+  pos_ = 0;
+  len_ = (size_t)r;
+  return readSome(dst, n, idleMs, abort);
+}
+
+bool BufferedReader::readExact(uint8_t* dst, size_t n, uint32_t idleMs) {
+  size_t got = 0;
+  while (got < n) {
+    const int r = readSome(dst + got, n - got, idleMs);
+    if (r <= 0) return false;
+    got += (size_t)r;
+  }
+  return true;
+}
+
+int BufferedReader::readLine(char* out, size_t cap, uint32_t idleMs) {
+  if (!out || cap == 0) return -1;
+  size_t n = 0;
+  while (true) {
+    if (pos_ == len_) {
+      const int a = wait_(idleMs, nullptr);
+      if (a <= 0) return -1;
+      const int r = c_->read(buf_, ((size_t)a < kBufBytes) ? (size_t)a : kBufBytes);
+      if (r <= 0) return -1;
+      pos_ = 0;
+      len_ = (size_t)r;
+    }
+    const uint8_t* s = buf_ + pos_;
+    const uint8_t* nl = (const uint8_t*)memchr(s, '\n', len_ - pos_);
+    const size_t take = nl ? (size_t)(nl - s) : len_ - pos_;
+    for (size_t i = 0; i < take; ++i) {
+      if (s[i] == '\r') continue;
+      if (n + 1 >= cap) return -1;  // too long
+      out[n++] = (char)s[i];
+    }
+    pos_ += take;
+    if (nl) {
+      ++pos_;
+      out[n] = '\0';
+      return (int)n;
+    }
+  }
+}
@@ -0,0 +1,43 @@
+// Module implementation.
+// Buffered reader over an Arduino Client (WiFiClient / WiFiClientSecure).
+//
+// Pulls up to kBufBytes per socket read instead of one byte per read(), so
+// line parsing (HTTP chunk sizes, token body, DUCO pool lines) does not go
+// through the TLS record layer byte by byte, and it only waits (delay(1))
+// when the buffer is empty.
+//
+// NOTE:
+// - Not thread-safe: one owner task per instance. Keep instances off small
+//   task stacks (member / file-scope).
+// - attach() drops whatever was buffered for the previous connection.
+#pragma once
+#include <Arduino.h>
+#include <Client.h>
+
+#include <atomic>
+
+class BufferedReader {
+public:
+  static constexpr size_t kBufBytes = 2048;
+  void attach(Client* c) {
+    c_ = c;
+    pos_ = len_ = 0;
+  }
+  // Bytes readable without waiting (buffered + socket).
+  int available();
+  // One line without CR / LF into out (NUL-terminated). Returns its length,
+  // or -1 on timeout, close, or a line longer than cap - 1.
+  int readLine(char* out, size_t cap, uint32_t idleMs);
+  bool readExact(uint8_t* dst, size_t n, uint32_t idleMs);
+  // Up to n bytes, waiting up to idleMs for the first one: >0 bytes,
+  // 0 = peer closed and everything consumed, -1 = timeout / abort.
+  int readSome(uint8_t* dst, size_t n, uint32_t idleMs,
+               const std::atomic<bool>* abort = nullptr);
+private:
+  // Wait for the socket: >0 bytes ready, 0 = closed, -1 = timeout / abort.
+  int wait_(uint32_t idleMs, const std::atomic<bool>* abort);
+  Client* c_ = nullptr;
+  uint8_t buf_[kBufBytes];
+  size_t pos_ = 0;
+  size_t len_ = 0;
+};
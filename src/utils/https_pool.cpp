@@ -0,0 +1,197 @@
+// Module implementation.
+#include "utils/https_pool.h"
+
+#include <string.h>
+
+#include <new>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "config/config.h"
+#include "utils/logging.h"
+
+namespace https_pool {
+struct Lease::Conn {
+  WiFiClientSecure c_;
+  HTTPClient h_;
+};
+
+namespace {
+static constexpr int kSlots = MC_HTTPS_POOL_SLOTS;
+static const uint32_t kIdleMs = MC_HTTPS_POOL_IDLE_MS;
+static const uint32_t kMinHeap = MC_HTTPS_POOL_MIN_HEAP;
+
+struct Slot {
+  Lease::Conn* c_ = nullptr;   // created on first use, kept
+  char     host_[80] = {0};
+  uint16_t port_ = 0;
+  bool     busy_ = false;
+  uint32_t lastUseMs_ = 0;
+};
+static Slot g_slots[kSlots > 0 ? kSlots : 1];
+static Stats g_stats;
+static SemaphoreHandle_t g_mutex = nullptr;
+static portMUX_TYPE g_initMux = portMUX_INITIALIZER_UNLOCKED;
+
+struct Lock_ {
+  Lock_() {
+    if (!g_mutex) {
+      SemaphoreHandle_t m = xSemaphoreCreateMutex();
+      portENTER_CRITICAL(&g_initMux);
+      if (!g_mutex) {
+        g_mutex = m;
+        m = nullptr;
+      }
+      portEXIT_CRITICAL(&g_initMux);
+      if (m) vSemaphoreDelete(m);
+    }
+    xSemaphoreTake(g_mutex, portMAX_DELAY);
+  }
+  ~Lock_() { xSemaphoreGive(g_mutex); }
+};
+
+// "https://host[:port]/..." -> host, port (443 by default).
+static bool parseHost_(const char* url, char* host, size_t cap, uint16_t* port) {
+  if (!url || strncmp(url, "https://", 8) != 0) return false;
+  const char* h = url + 8;
+  const size_t n = strcspn(h, ":/?");
+  if (n == 0 || n >= cap) return false;
+  memcpy(host, h, n);
+  host[n] = '\0';
+  *port = (h[n] == ':') ? (uint16_t)atoi(h + n + 1) : 443;
+  return *port != 0;
+}
+// Caller holds the lock. Warm = still open and used recently enough.
+static bool warm_(Slot& s, uint32_t now) {
+  if (!s.c_ || !s.c_->c_.connected()) return false;
+  if (now - s.lastUseMs_ > kIdleMs) {
+    s.c_->c_.stop();
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+bool Lease::acquire(const char* url) {
+  release();
+  char host[sizeof(Slot::host_)];
+  uint16_t port = 0;
+  const bool keyed = parseHost_(url, host, sizeof(host), &port);
+  Stats st;
+  {
+    Lock_ l;
+    const uint32_t now = millis();
+    int pick = -1;
+    for (int i = 0; keyed && i < kSlots; ++i) {
+      Slot& s = g_slots[i];
+      if (s.busy_ || s.port_ != port || strcmp(s.host_, host) != 0) continue;
+      pick = i;
+      reused_ = warm_(s, now);
+      break;
+    }
+    if (pick < 0 && keyed) {
+      // Free slot for this host: an unused one, else the least recently used.
+      for (int i = 0; i < kSlots; ++i) {
+        Slot& s = g_slots[i];
+        if (s.busy_) continue;
+        if (!s.host_[0]) {
+          pick = i;
+          break;
+        }
+        if (pick < 0 || (int32_t)(s.lastUseMs_ - g_slots[pick].lastUseMs_) < 0) pick = i;
+      }
+      if (pick >= 0) {
+        Slot& s = g_slots[pick];
+        if (s.c_) s.c_->c_.stop();
+        strcpy(s.host_, host);
+        s.port_ = port;
+      }
+    }
+    if (pick >= 0) {
+      Slot& s = g_slots[pick];
+      if (!s.c_) s.c_ = new (std::nothrow) Conn();
+      if (s.c_) {
+        s.busy_ = true;
+        slot_ = (int8_t)pick;
+        c_ = s.c_;
+      } else {
+        reused_ = false;
+      }
+    }
+    if (reused_) {
+      ++g_stats.reuses_;
+    } else {
+      ++g_stats.handshakes_;
+      // The handshake needs heap; expired or (when short) all idle ones go.
+      const bool shortHeap = ESP.getMaxAllocHeap() < kMinHeap;
+      for (int i = 0; i < kSlots; ++i) {
+        Slot& s = g_slots[i];
+        if (i == pick || s.busy_ || !s.c_) continue;
+        if (shortHeap || !warm_(s, now)) s.c_->c_.stop();
+      }
+    }
+    st = g_stats;
+  }
+  if (!c_) c_ = new (std::nothrow) Conn();
+  if (!c_) return false;
+  c_->c_.setInsecure();
+  MC_LOGD("NET", "lease %s:%u %s slot=%d (hs=%lu reuse=%lu stale=%lu)",
+          keyed ? host : "?", (unsigned)port, reused_ ? "reuse" : "new", (int)slot_,
+          (unsigned long)st.handshakes_, (unsigned long)st.reuses_,
+          (unsigned long)st.stale_);
+  return true;
+}
+
+WiFiClientSecure& Lease::client() { return c_->c_; }
+HTTPClient& Lease::http() { return c_->h_; }
+
+bool Lease::retryFresh(int httpCode, bool resendSafe) {
+  if (!c_ || !reused_) return false;
+  switch (httpCode) {
+  case HTTPC_ERROR_CONNECTION_REFUSED:
+  case HTTPC_ERROR_SEND_HEADER_FAILED:
+  case HTTPC_ERROR_SEND_PAYLOAD_FAILED:
+    break;  // the request never got out whole
+  case HTTPC_ERROR_NOT_CONNECTED:
+  case HTTPC_ERROR_CONNECTION_LOST:
+    // Reported after the whole request was written.
+    if (!resendSafe) return false;
+    break;
+  default:
+    return false;  // got a response, or timed out after sending
+  }
+  c_->c_.stop();
+  reused_ = false;
+  {
+    Lock_ l;
+    ++g_stats.stale_;
+    ++g_stats.handshakes_;
+  }
+  MC_LOGD("NET", "stale keep-alive (code=%d) -> new connection", httpCode);
+  return true;
+}
+
+void Lease::release() {
+  if (!c_) return;
+  c_->h_.end();  // no-op when the caller already ended it
+  if (slot_ < 0) {
+    delete c_;
+  } else {
+    Lock_ l;
+    // A warm connection keeps its TLS buffers; give them back when short.
+    if (c_->c_.connected() && ESP.getMaxAllocHeap() < kMinHeap) c_->c_.stop();
+    Slot& s = g_slots[slot_];
+    s.lastUseMs_ = millis();
+    s.busy_ = false;
+  }
+  c_ = nullptr;
+  slot_ = -1;
+  reused_ = false;
+}
+
+Stats stats() {
+  Lock_ l;
+  return g_stats;
+}
+} // namespace https_pool
@@ -0,0 +1,65 @@
+// Module implementation.
+// Shared pool of warm HTTPS (TLS) connections, one per host.
+//
+// STT, LLM, the Azure token fetch and DUCO getPool used to build a new
+// WiFiClientSecure per request and pay a full TLS handshake every time. A
+// caller now takes a Lease for its URL and runs lease.http() on
+// lease.client() with reuse on; the kept-alive connection goes back to the
+// pool when the lease ends. The next request to the same host within the
+// idle window skips the handshake.
+//
+// NOTE:
+// - The Arduino WiFiClientSecure API does not expose the mbedTLS session,
+//   so there is no session-ticket resumption; reuse is HTTP/1.1 keep-alive.
+// - A kept connection may have been closed by the server. When a request on
+//   a reused connection fails at the socket level, retryFresh() drops it and
+//   the caller sends once more on a new connection. Requests that must not
+//   run twice (LLM, STT) only retry when the request was never fully sent.
+// - The HTTPClient lives with the connection: a destroyed HTTPClient stops
+//   its client, so callers must not wrap lease.client() in their own.
+// - Thread-safe; a slot has one lease at a time. When every slot is leased
+//   (or MC_HTTPS_POOL_SLOTS is 0) the lease gets a private one-shot client.
+// - Idle connections hold TLS buffers; they are closed after
+//   MC_HTTPS_POOL_IDLE_MS, and when the heap is short (at release, or
+//   before another lease's handshake).
+#pragma once
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+
+namespace https_pool {
+struct Stats {
+  uint32_t handshakes_ = 0;   // new connections handed out
+  uint32_t reuses_ = 0;       // warm connections handed out
+  uint32_t stale_ = 0;        // reused ones the server had closed (retried)
+};
+
+class Lease {
+public:
+  Lease() = default;
+  ~Lease() { release(); }
+  Lease(const Lease&) = delete;
+  Lease& operator=(const Lease&) = delete;
+  // Connection for url's host (https://host[:port]/...); false = no memory.
+  bool acquire(const char* url);
+  WiFiClientSecure& client();
+  HTTPClient& http();
+  bool reused() const { return reused_; }
+  // httpCode from a request on this lease. True when it failed on a reused
+  // connection and may be sent once more (now a fresh handshake); the
+  // connection is dropped. resendSafe = false (non-idempotent POST): only
+  // when the request did not get out whole (connect / header / payload
+  // write), never after it was sent and the peer closed (NOT_CONNECTED /
+  // CONNECTION_LOST), since the server may already have acted on it.
+  bool retryFresh(int httpCode, bool resendSafe);
+  // Return the connection (kept warm if still open). Also done by ~Lease.
+  void release();
+  struct Conn;
+private:
+  Conn*  c_ = nullptr;
+  int8_t slot_ = -1;          // -1 = private connection (deleted at release)
+  bool reused_ = false;
+};
+
+Stats stats();
+} // namespace https_pool
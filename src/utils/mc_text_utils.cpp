@@ -1,5 +1,7 @@
 ﻿// Module implementation.
 #include "utils/mc_text_utils.h"
+
+#include <string.h>
 static size_t utf8SeqLen_(uint8_t c) {
   if (c < 0x80) return 1;
   if ((c & 0xE0) == 0xC0) return 2;
@@ -39,3 +41,82 @@ String mcSanitizeOneLine(const String& s) {
 String mcLogHead(const String& s, size_t maxBytes) {
   return mcUtf8ClampBytes(mcSanitizeOneLine(s), maxBytes);
 }
+// Sentence-final marks: 。 ！ ？ ． …
+static bool isFullwidthStop_(const char* p, size_t L) {
+  if (L != 3) return false;
+  return memcmp(p, "\xE3\x80\x82", 3) == 0 || memcmp(p, "\xEF\xBC\x81", 3) == 0 ||
+         memcmp(p, "\xEF\xBC\x9F", 3) == 0 || memcmp(p, "\xEF\xBC\x8E", 3) == 0 ||
+         memcmp(p, "\xE2\x80\xA6", 3) == 0;
+}
+// Marks that trail a sentence end: 」 』 ） and ASCII ) " '
+static bool isCloser_(const char* p, size_t L) {
+  if (L == 1) return *p == ')' || *p == '"' || *p == '\'';
+  if (L != 3) return false;
+  return memcmp(p, "\xE3\x80\x8D", 3) == 0 || memcmp(p, "\xE3\x80\x8F", 3) == 0 ||
+         memcmp(p, "\xEF\xBC\x89", 3) == 0;
+}
+static bool isAsciiStop_(char c) {
+  return c == '.' || c == '!' || c == '?';
+}
+size_t mcSplitSentences(const String& s, String* out, size_t maxOut, size_t minBytes) {
+  if (!out || maxOut == 0) return 0;
+  const char* p = s.c_str();
+  const size_t n = s.length();
+  size_t count = 0;
+  size_t start = 0;
+  auto emit = [&](size_t end) {
+    String seg = s.substring((unsigned)start, (unsigned)end);
+    start = end;
+    if (count > 0 && (out[count - 1].length() < minBytes || count == maxOut)) {
+      out[count - 1] += seg;
+      return;
+    }
+    String t = seg;
+    t.trim();
+    if (!t.length()) {
+      if (count > 0) out[count - 1] += seg;
+      return;
+    }
+    out[count++] = seg;
+  };
+  auto seqAt = [&](size_t i) {
+    const size_t L = utf8SeqLen_((uint8_t)p[i]);
+    return (i + L > n) ? n - i : L;
+  };
+  size_t i = 0;
+  while (i < n) {
+    const size_t L = seqAt(i);
+    bool stop = (p[i] == '\n') || isFullwidthStop_(p + i, L);
+    if (!stop && L == 1 && isAsciiStop_(p[i])) {
+      // "3.5" / "e.g.x" are not sentence ends; a space, the end or a
+      // non-ASCII character after the mark is.
+      const uint8_t next = (i + 1 < n) ? (uint8_t)p[i + 1] : 0;
+      stop = next == 0 || next == ' ' || next == '\n' || next >= 0x80 ||
+             isAsciiStop_((char)next);
+    }
+    if (!stop) {
+      i += L;
+      continue;
+    }
+    size_t j = i + L;
+    while (j < n) {
+      const size_t L2 = seqAt(j);
+      if (isFullwidthStop_(p + j, L2) || isCloser_(p + j, L2) ||
+          (L2 == 1 && isAsciiStop_(p[j]))) {
+        j += L2;
+      } else {
+        break;
+      }
+    }
+    emit(j);
+    i = j;
+  }
+  if (start < n) emit(n);
+  // A short tail joins the piece before it.
+  if (count > 1 && out[count - 1].length() < minBytes) {
+    out[count - 2] += out[count - 1];
+    --count;
+  }
+  for (size_t k = 0; k < count; ++k) out[k].trim();
+  return count;
+}
@@ -14,3 +14,8 @@ String mcUtf8ClampBytes(const String& s, size_t maxBytes);
 String mcSanitizeOneLine(const String& s);
 // Convenience for logs: mcUtf8ClampBytes(mcSanitizeOneLine(s), maxBytes)
 String mcLogHead(const String& s, size_t maxBytes);
+// Split at sentence ends (。！？… / Latin .!? before a space, newline) for
+// segment-by-segment TTS. Closing brackets stay with their sentence; pieces
+// shorter than minBytes are merged into a neighbour and the remainder past
+// maxOut goes into the last piece. Returns the number of pieces in out[].
+size_t mcSplitSentences(const String& s, String* out, size_t maxOut, size_t minBytes);
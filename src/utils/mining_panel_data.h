@@ -13,6 +13,7 @@ struct MiningPanelData {
   bool     poolAlive_     = false;
   bool     miningEnabled_ = false;
   float    diff_          = 0.0f;
+  uint8_t  govLevel_      = 0;      // mining governor level (0 = full speed)
   uint32_t elapsedS_  = 0;
   String   sw_;
   String   fw_;
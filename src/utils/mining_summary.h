@@ -3,11 +3,34 @@
 #include <Arduino.h>
 #include <stdint.h>
 
+// Thermal / battery governor policy (core/mining_governor.cpp).
+struct MiningGovernorState {
+  uint8_t level_ = 0;          // 0 = full speed .. 4 = mining stopped
+  const char* reason_ = "off"; // "off" / "ok" / "temp" / "batt" / "batt_low" / "batt_crit"
+  float tempC_ = 0.0f;
+  int battPct_ = -1;
+  bool extPower_ = true;
+  uint16_t cpuMhz_ = 0;
+  uint8_t threads_ = 0;
+};
+
 struct MiningSummary {
-  float totalKh_ = 0.0f;
+  float totalKh_ = 0.0f;     // hashrate EWMA (ai/mining_series.h)
+  float khMin1m_ = 0.0f;     // per-second hashrate over the last minute
+  float khMax1m_ = 0.0f;
+  float khP50_1m_ = 0.0f;
+  float sharesPerMin_ = 0.0f;  // accepted share rate EWMA
+  float pingP90Ms_ = 0.0f;     // over the last minute
+  float coreKh_[2] = {0.0f, 0.0f};  // per-core hashrate (MC_DUCO_MEASURE_MS window)
   uint32_t accepted_ = 0;
   uint32_t rejected_ = 0;
   float maxPingMs_ = 0.0f;
+  float dutyPct_ = 0.0f;  // hashing time / wall time of active workers (%)
+  uint16_t yieldEvery_ = 0;  // yield profile in effect (hashes between yields)
+  uint8_t yieldMs_ = 0;      // ... and the sleep at each yield point
+  bool yieldAuto_ = false;   // profile chosen by the autotuner
+  const char* yieldState_ = "";  // MiningYieldTuner::stateName()
+  MiningGovernorState gov_;
   uint32_t maxDifficulty_ = 0;
   bool anyConnected_ = false;
   String poolName_;
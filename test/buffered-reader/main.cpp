@@ -0,0 +1,377 @@
+// BufferedReader tests (host).
+//
+//   pio run -e native-reader && .pio/build/native-reader/program
+//
+// ScriptedClient hands out a scripted list of segments, at most one segment
+// per read() (the way TLS records / TCP segments arrive), so line and chunk
+// boundaries can be put anywhere. The shim's millis() only moves on delay(),
+// so timeouts are checked without waiting.
+// Exit code 1 on any failed check.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <deque>
+#include <string>
+
+#include "utils/buffered_reader.h"
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+              #cond);                                                 \
+      ++g_failures;                                                   \
+    }                                                                 \
+  } while (0)
+
+class ScriptedClient : public Client {
+public:
+  // Segment readable from fake time atMs on.
+  void push(const std::string& data, uint32_t atMs = 0) { segs_.push_back({data, atMs}); }
+  // Split data into size-byte segments.
+  void pushSplit(const std::string& data, size_t size) {
+    for (size_t i = 0; i < data.size(); i += size) push(data.substr(i, size));
+  }
+  // After the script: closed (false) or open with nothing more to read.
+  void stayOpen(bool open) { open_ = open; }
+  int available() override {
+    if (segs_.empty() || millis() < segs_.front().atMs_) return 0;
+    return (int)segs_.front().data_.size();
+  }
+  uint8_t connected() override { return open_ || !segs_.empty(); }
+  int read(uint8_t* buf, size_t size) override {
+    ++reads_;
+    const int a = available();
+    if (a <= 0) return -1;
+    std::string& d = segs_.front().data_;
+    const size_t n = (size < (size_t)a) ? size : (size_t)a;
+    memcpy(buf, d.data(), n);
+    d.erase(0, n);
+    if (d.empty()) segs_.pop_front();
+    return (int)n;
+  }
+  int reads_ = 0;
+private:
+  struct Seg {
+    std::string data_;
+    uint32_t atMs_;
+  };
+  std::deque<Seg> segs_;
+  bool open_ = false;
+};
+
+std::string pattern_(size_t n) {
+  std::string s(n, '\0');
+  for (size_t i = 0; i < n; ++i) s[i] = (char)(i * 7 + (i >> 8));
+  return s;
+}
+
+void testLinesAcrossReads_() {
+  ScriptedClient c;
+  c.push("HTTP/1.1 200 OK\r");
+  c.push("\nContent-Type: a");
+  c.push("udio/wav\r\n\r\nbare\nlf");
+  c.push("-line\n");
+  c.push("\r");
+  c.push("\n");
+  BufferedReader rx;
+  rx.attach(&c);
+  char line[64];
+  CHECK(rx.readLine(line, sizeof(line), 100) == 15);
+  CHECK(strcmp(line, "HTTP/1.1 200 OK") == 0);
+  CHECK(rx.readLine(line, sizeof(line), 100) == 23);
+  CHECK(strcmp(line, "Content-Type: audio/wav") == 0);
+  // Buffered rest of the segment + the next segment on the socket.
+  CHECK(rx.available() == (int)strlen("\r\nbare\nlf") + 6);
+  CHECK(rx.readLine(line, sizeof(line), 100) == 0);
+  CHECK(rx.readLine(line, sizeof(line), 100) == 4);
+  CHECK(strcmp(line, "bare") == 0);
+  CHECK(rx.readLine(line, sizeof(line), 100) == 7);
+  CHECK(strcmp(line, "lf-line") == 0);
+  // CR and LF in separate reads.
+  CHECK(rx.readLine(line, sizeof(line), 100) == 0);
+  CHECK(c.reads_ == 6);
+  CHECK(rx.readLine(line, sizeof(line), 100) == -1);  // closed
+}
+
+void testOverlongLine_() {
+  char line[64];
+  {
+    // In one segment: nothing of the line is consumed.
+    ScriptedClient c;
+    c.push("0123456789ABCDEF\nnext\n");
+    BufferedReader rx;
+    rx.attach(&c);
+    CHECK(rx.readLine(line, 8, 100) == -1);
+    CHECK(rx.available() == 22);
+    CHECK(rx.readLine(line, sizeof(line), 100) == 16);
+    CHECK(strcmp(line, "0123456789ABCDEF") == 0);
+    CHECK(rx.readLine(line, sizeof(line), 100) == 4);
+    CHECK(strcmp(line, "next") == 0);
+  }
+  {
+    // Across segments: the earlier segments' part is gone, the rest of the
+    // line is still buffered.
+    ScriptedClient c;
+    c.push("01234");
+    c.push("56789ABCDEF\nnext\n");
+    BufferedReader rx;
+    rx.attach(&c);
+    CHECK(rx.readLine(line, 8, 100) == -1);
+    CHECK(rx.available() == 17);
+    CHECK(rx.readLine(line, sizeof(line), 100) == 11);
+    CHECK(strcmp(line, "56789ABCDEF") == 0);
+    CHECK(rx.readLine(line, sizeof(line), 100) == 4);
+    CHECK(strcmp(line, "next") == 0);
+  }
+  {
+    // cap - 1 characters fit; a CR does not count.
+    ScriptedClient c;
+    c.push("1234567\r\n12345678\n");
+    BufferedReader rx;
+    rx.attach(&c);
+    CHECK(rx.readLine(line, 8, 100) == 7);
+    CHECK(strcmp(line, "1234567") == 0);
+    CHECK(rx.readLine(line, 8, 100) == -1);
+  }
+  {
+    // Longer than kBufBytes itself: fine when out is big enough.
+    const std::string big(BufferedReader::kBufBytes + 900, 'x');
+    ScriptedClient c;
+    c.pushSplit(big + "\r\ntail\n", 1460);
+    BufferedReader rx;
+    rx.attach(&c);
+    static char out[BufferedReader::kBufBytes * 2];
+    CHECK(rx.readLine(out, sizeof(out), 100) == (int)big.size());
+    CHECK(big == out);
+    CHECK(rx.readLine(line, sizeof(line), 100) == 4);
+    CHECK(strcmp(line, "tail") == 0);
+  }
+}
+
+void testReadExactRefills_() {
+  const std::string body = pattern_(5000);
+  ScriptedClient c;
+  c.pushSplit(body, 1460);
+  BufferedReader rx;
+  rx.attach(&c);
+  static uint8_t out[5000];
+  CHECK(rx.readExact(out, 3, 100));
+  CHECK(c.reads_ == 1);
+  CHECK(rx.readExact(out + 3, 4000, 100));
+  CHECK(rx.readExact(out + 4003, 997, 100));
+  CHECK(memcmp(out, body.data(), body.size()) == 0);
+  CHECK(rx.available() == 0);
+  CHECK(!rx.readExact(out, 1, 100));  // closed
+
+  // Short body: false once the peer closes.
+  ScriptedClient s;
+  s.push("abc");
+  s.push("de");
+  rx.attach(&s);
+  CHECK(!rx.readExact(out, 6, 100));
+
+  // readSome: buffered bytes first, large reads straight from the socket.
+  ScriptedClient d;
+  d.push("hdr\n" + body.substr(0, 100));
+  d.push(body.substr(100, 3000));
+  rx.attach(&d);
+  char line[8];
+  CHECK(rx.readLine(line, sizeof(line), 100) == 3);
+  CHECK(rx.readSome(out, 4096, 100) == 100);
+  CHECK(rx.readSome(out + 100, 4096, 100) == 3000);
+  CHECK(memcmp(out, body.data(), 3100) == 0);
+  CHECK(rx.readSome(out, 4096, 100) == 0);  // closed, all consumed
+}
+
+// Same framing as TtsBodyReader_ in ai/azure_tts.cpp.
+struct ChunkedBody_ {
+  BufferedReader* rx_ = nullptr;
+  bool afterChunk_ = false;
+  bool eof_ = false;
+  size_t left_ = 0;
+  static bool parseChunkSize_(char* line, unsigned long* out) {
+    char* p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    char* semi = strchr(p, ';');
+    if (semi) *semi = 0;
+    char* endp = nullptr;
+    *out = strtoul(p, &endp, 16);
+    return endp && endp != p;
+  }
+  static bool isBlank_(const char* s) {
+    while (*s == ' ' || *s == '\t') s++;
+    return *s == 0;
+  }
+  int read(uint8_t* dst, size_t n) {
+    if (eof_) return 0;
+    if (left_ == 0) {
+      if (afterChunk_) {
+        char crlf[2];
+        if (!rx_->readExact((uint8_t*)crlf, 2, 100)) return -1;
+        afterChunk_ = false;
+      }
+      char line[64 + 1];
+      do {
+        if (rx_->readLine(line, sizeof(line), 100) < 0) return -1;
+      } while (isBlank_(line));
+      unsigned long chunk = 0;
+      if (!parseChunkSize_(line, &chunk)) return -1;
+      if (chunk == 0) {
+        (void)rx_->readLine(line, sizeof(line), 50);
+        eof_ = true;
+        return 0;
+      }
+      left_ = (size_t)chunk;
+      afterChunk_ = true;
+    }
+    const int r = rx_->readSome(dst, (n < left_) ? n : left_, 100);
+    if (r <= 0) return -1;
+    left_ -= (size_t)r;
+    return r;
+  }
+  // Whole body into out; -1 on a framing / read error.
+  int readAll(std::string& out, size_t step) {
+    uint8_t tmp[4096];
+    while (true) {
+      const int r = read(tmp, step);
+      if (r < 0) return -1;
+      if (r == 0) return (int)out.size();
+      out.append((const char*)tmp, (size_t)r);
+    }
+  }
+};
+
+void testChunkedFraming_() {
+  const std::string a = "hello";
+  const std::string b = pattern_(0x1a);
+  const std::string big = pattern_(3000);
+  const std::string wire = "5\r\n" + a + "\r\n" + "1a;ext=1\r\n" + b + "\r\n" +
+                           " bb8\r\n" + big + "\r\n" + "0\r\n\r\n";
+  const std::string want = a + b + big;
+  for (size_t seg : {(size_t)1, (size_t)2, (size_t)3, (size_t)7, (size_t)1460, wire.size()}) {
+    for (size_t step : {(size_t)1, (size_t)13, (size_t)4096}) {
+      ScriptedClient c;
+      c.pushSplit(wire, seg);
+      BufferedReader rx;
+      rx.attach(&c);
+      ChunkedBody_ br;
+      br.rx_ = &rx;
+      std::string got;
+      CHECK(br.readAll(got, step) == (int)want.size());
+      CHECK(got == want);
+      CHECK(rx.available() == 0);
+    }
+  }
+  // Cut inside a chunk / inside a size line.
+  for (size_t cut : {(size_t)2, (size_t)6, (size_t)12, wire.size() - 8}) {
+    ScriptedClient c;
+    c.pushSplit(wire.substr(0, cut), 4);
+    BufferedReader rx;
+    rx.attach(&c);
+    ChunkedBody_ br;
+    br.rx_ = &rx;
+    std::string got;
+    CHECK(br.readAll(got, 4096) == -1);
+  }
+  // Not a size line.
+  ScriptedClient c;
+  c.push("zz\r\nhello\r\n0\r\n\r\n");
+  BufferedReader rx;
+  rx.attach(&c);
+  ChunkedBody_ br;
+  br.rx_ = &rx;
+  std::string got;
+  CHECK(br.readAll(got, 4096) == -1);
+}
+
+void testEofMidLine_() {
+  ScriptedClient c;
+  c.push("GOOD\npartial li");
+  c.push("ne without LF");
+  BufferedReader rx;
+  rx.attach(&c);
+  char line[64];
+  CHECK(rx.readLine(line, sizeof(line), 100) == 4);
+  const uint32_t t0 = millis();
+  CHECK(rx.readLine(line, sizeof(line), 1000) == -1);
+  CHECK(millis() == t0);  // closed: no waiting for the timeout
+  uint8_t b;
+  CHECK(rx.readSome(&b, 1, 100) == 0);
+}
+
+void testTimeout_() {
+  char line[64];
+  uint8_t buf[16];
+  {
+    ScriptedClient c;
+    c.stayOpen(true);
+    c.push("abc");
+    BufferedReader rx;
+    rx.attach(&c);
+    const uint32_t t0 = millis();
+    CHECK(rx.readLine(line, sizeof(line), 200) == -1);
+    CHECK(millis() - t0 > 200 && millis() - t0 < 210);
+    CHECK(rx.readSome(buf, sizeof(buf), 50) == -1);
+    CHECK(!rx.readExact(buf, 1, 50));
+  }
+  {
+    // Data that shows up within the idle window is waited for.
+    ScriptedClient c;
+    c.stayOpen(true);
+    const uint32_t t0 = millis();
+    c.push("late\n", t0 + 150);
+    c.push("later\n", t0 + 500);
+    BufferedReader rx;
+    rx.attach(&c);
+    CHECK(rx.readLine(line, sizeof(line), 200) == 4);
+    CHECK(millis() - t0 == 150);
+    CHECK(rx.readLine(line, sizeof(line), 200) == -1);
+    CHECK(rx.readLine(line, sizeof(line), 200) == 5);
+    CHECK(strcmp(line, "later") == 0);
+  }
+  {
+    // Abort ends the wait at once.
+    ScriptedClient c;
+    c.stayOpen(true);
+    BufferedReader rx;
+    rx.attach(&c);
+    std::atomic<bool> abort(true);
+    const uint32_t t0 = millis();
+    CHECK(rx.readSome(buf, sizeof(buf), 5000, &abort) == -1);
+    CHECK(millis() == t0);
+  }
+  {
+    // attach() drops what was buffered for the previous connection.
+    ScriptedClient c;
+    c.push("one\ntwo\n");
+    BufferedReader rx;
+    rx.attach(&c);
+    CHECK(rx.readLine(line, sizeof(line), 100) == 3);
+    ScriptedClient d;
+    rx.attach(&d);
+    CHECK(rx.available() == 0);
+    CHECK(rx.readLine(line, sizeof(line), 100) == -1);
+  }
+}
+} // namespace
+
+int main() {
+  testLinesAcrossReads_();
+  testOverlongLine_();
+  testReadExactRefills_();
+  testChunkedFraming_();
+  testEofMidLine_();
+  testTimeout_();
+  if (g_failures) {
+    fprintf(stderr, "buffered_reader: %d check(s) failed\n", g_failures);
+    return 1;
+  }
+  printf("buffered_reader: all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,12 @@
+// Host shim: the parts of Arduino.h that utils/buffered_reader uses.
+// millis() is a fake clock that only delay() moves, so idle timeouts run
+// instantly and tests can check how long a call waited.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace fake_clock {
+inline uint32_t g_nowMs = 0;
+}
+inline uint32_t millis() { return fake_clock::g_nowMs; }
+inline void delay(uint32_t ms) { fake_clock::g_nowMs += ms; }
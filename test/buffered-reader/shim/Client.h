@@ -0,0 +1,11 @@
+// Host shim: the Client calls utils/buffered_reader makes.
+#pragma once
+#include "Arduino.h"
+
+class Client {
+public:
+  virtual ~Client() = default;
+  virtual int available() = 0;
+  virtual uint8_t connected() = 0;
+  virtual int read(uint8_t* buf, size_t size) = 0;
+};
@@ -0,0 +1,248 @@
+// DUCO line codec tests (host).
+//
+//   pio run -e native-protocol && .pio/build/native-protocol/program
+//
+// Job lines are the pool jobs the mining bench uses, byte for byte as the
+// pool sends them (prev,expected,diff + "\n"); their solving nonce is known,
+// so a parsed job is also checked by hashing seed + nonce against the target.
+// Feedback lines are the pool's replies (GOOD / BAD,<reason> / BLOCK).
+// Exit code 1 on any failed check.
+#include <stdio.h>
+#include <string.h>
+
+#include "ai/duco_protocol.h"
+#include "ai/duco_sha1.h"
+
+namespace {
+int g_failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+              #cond);                                                 \
+      ++g_failures;                                                   \
+    }                                                                 \
+  } while (0)
+
+struct PoolJob {
+  const char* line;
+  const char* prev;
+  uint32_t diff;
+  uint32_t nonce;
+};
+const PoolJob kPoolJobs[] = {
+  {"a4c123b1612dd272d1371c17149d439536b3216f,995ed64f70f98777cf5d3672a971a0d941c7b591,1500\n",
+   "a4c123b1612dd272d1371c17149d439536b3216f", 1500, 149181},
+  {"daeeb975729fae923d5a4fd12aabfe228f219e9c,7b85712fe71ca705b7165a8fa72928dea67b5ff2,3000\n",
+   "daeeb975729fae923d5a4fd12aabfe228f219e9c", 3000, 295283},
+  {"b0eb53f16947ccf25ec84d8dbc74254770f58904,685e75d8ff2660174eb1ad98dd345260da62c0c8,6000\r\n",
+   "b0eb53f16947ccf25ec84d8dbc74254770f58904", 6000, 459648},
+};
+const char* kPrev = "a4c123b1612dd272d1371c17149d439536b3216f";
+const char* kExpected = "995ed64f70f98777cf5d3672a971a0d941c7b591";
+
+bool parse_(const char* line, duco_protocol::Job& j) {
+  return duco_protocol::parseJob(line, strlen(line), j);
+}
+
+void testParseJobPoolLines_() {
+  for (const PoolJob& pj : kPoolJobs) {
+    duco_protocol::Job j;
+    CHECK(parse_(pj.line, j));
+    CHECK(j.seedLen_ == 40);
+    CHECK(strcmp(j.seed_, pj.prev) == 0);
+    CHECK(j.difficulty_ == pj.diff);
+    // seed + known nonce hashes to the parsed target.
+    duco_sha1::Midstate mid;
+    CHECK(duco_sha1::prepare(mid, j.seed_, j.seedLen_));
+    char nonce[duco_sha1::kMaxNonceDigits];
+    const int n = duco_sha1::u32ToDec(nonce, pj.nonce);
+    uint32_t h[5];
+    duco_sha1::hash(mid, nonce, (size_t)n, h);
+    CHECK(duco_sha1::matches(h, j.target_));
+  }
+  duco_protocol::Job j;
+  CHECK(parse_(kPoolJobs[0].line, j));
+  CHECK(j.target_[0] == 0x995ed64fu && j.target_[4] == 0x41c7b591u);
+  // Without the line ending (as ducoReadLine_ hands it over).
+  CHECK(duco_protocol::parseJob(kPoolJobs[0].line, strlen(kPoolJobs[0].line) - 1, j));
+  CHECK(j.difficulty_ == 1500);
+}
+
+void testParseJobTruncated_() {
+  duco_protocol::Job j;
+  // Cut inside the expected hash: no difficulty field.
+  CHECK(!parse_("a4c123b1612dd272d1371c17149d439536b3216f,995ed64f70f98777cf5d36", j));
+  // Cut inside the seed.
+  CHECK(!parse_("a4c123b1612dd272d137", j));
+  CHECK(!parse_("", j));
+  CHECK(!duco_protocol::parseJob(nullptr, 0, j));
+  // Cut right after the second comma: difficulty defaults to 1.
+  char line[128];
+  snprintf(line, sizeof(line), "%s,%s,", kPrev, kExpected);
+  CHECK(parse_(line, j));
+  CHECK(j.difficulty_ == 1);
+  // len shorter than the text: only the first len bytes count.
+  snprintf(line, sizeof(line), "%s,%s,1500\n", kPrev, kExpected);
+  CHECK(!duco_protocol::parseJob(line, 60, j));
+  // Empty seed.
+  snprintf(line, sizeof(line), ",%s,1500\n", kExpected);
+  CHECK(!parse_(line, j));
+}
+
+void testParseJobDifficulty_() {
+  duco_protocol::Job j;
+  char line[128];
+  snprintf(line, sizeof(line), "%s,%s,abc\n", kPrev, kExpected);
+  CHECK(parse_(line, j));
+  CHECK(j.difficulty_ == 1);
+  snprintf(line, sizeof(line), "%s,%s,-5\n", kPrev, kExpected);
+  CHECK(parse_(line, j));
+  CHECK(j.difficulty_ == 1);
+  // Leading digits only, like String::toInt().
+  snprintf(line, sizeof(line), "%s,%s,15x0\n", kPrev, kExpected);
+  CHECK(parse_(line, j));
+  CHECK(j.difficulty_ == 15);
+  snprintf(line, sizeof(line), "%s,%s, 3000 \r\n", kPrev, kExpected);
+  CHECK(parse_(line, j));
+  CHECK(j.difficulty_ == 3000);
+}
+
+void testParseJobOverlong_() {
+  duco_protocol::Job j;
+  char line[256];
+  // Expected hash one digit too long / short, or not hex: no nonce can hit
+  // that target, so the line is rejected and the job is never mined.
+  snprintf(line, sizeof(line), "%s,%s0,1500\n", kPrev, kExpected);
+  CHECK(!parse_(line, j));
+  snprintf(line, sizeof(line), "%s,%.39s,1500\n", kPrev, kExpected);
+  CHECK(!parse_(line, j));
+  snprintf(line, sizeof(line), "%s,995ed64f70f98777cf5d3672a971a0d941c7b59g,1500\n", kPrev);
+  CHECK(!parse_(line, j));
+  // Seed up to kMaxSeed is kept; one more is rejected.
+  char seed[duco_protocol::kMaxSeed + 2];
+  memset(seed, 'a', sizeof(seed) - 1);
+  seed[duco_protocol::kMaxSeed] = '\0';
+  snprintf(line, sizeof(line), "%s,%s,1500\n", seed, kExpected);
+  CHECK(parse_(line, j));
+  CHECK(j.seedLen_ == duco_protocol::kMaxSeed);
+  seed[duco_protocol::kMaxSeed] = 'a';
+  seed[duco_protocol::kMaxSeed + 1] = '\0';
+  snprintf(line, sizeof(line), "%s,%s,1500\n", seed, kExpected);
+  CHECK(!parse_(line, j));
+  CHECK(j.seedLen_ == 0 && j.seed_[0] == '\0');  // reset on failure
+}
+
+// Lines the net task must not turn into a job: parseJob() fails (the task
+// drops the connection) and leaves nothing to dispatch.
+void testMalformedNotSolved_() {
+  char longSeed[duco_protocol::kMaxSeed + 2];
+  memset(longSeed, 'a', sizeof(longSeed) - 1);
+  longSeed[sizeof(longSeed) - 1] = '\0';
+  char lines[6][256];
+  snprintf(lines[0], sizeof(lines[0]), "%s,%s0,1500\n", kPrev, kExpected);
+  snprintf(lines[1], sizeof(lines[1]), "%s,,1500\n", kPrev);
+  snprintf(lines[2], sizeof(lines[2]), "%s,%s\n", kPrev, kExpected);
+  snprintf(lines[3], sizeof(lines[3]), "%s,%s,1500\n", longSeed, kExpected);
+  snprintf(lines[4], sizeof(lines[4]), "BAD,Incorrect result\n");
+  snprintf(lines[5], sizeof(lines[5]), "%s,zz5ed64f70f98777cf5d3672a971a0d941c7b591,1\n", kPrev);
+  for (const char* line : lines) {
+    duco_protocol::Job j;
+    CHECK(parse_(kPoolJobs[0].line, j));  // a previous good job is cleared
+    CHECK(!parse_(line, j));
+    CHECK(j.seedLen_ == 0 && j.seed_[0] == '\0' && j.difficulty_ == 0);
+    CHECK(j.target_[0] == 0 && j.target_[4] == 0);
+  }
+}
+
+void testParseFeedback_() {
+  using duco_protocol::Feedback;
+  auto fb = [](const char* s) { return duco_protocol::parseFeedback(s, strlen(s)); };
+  CHECK(fb("GOOD\n") == Feedback::Good);
+  CHECK(fb("GOOD\r\n") == Feedback::Good);
+  CHECK(fb("GOOD") == Feedback::Good);
+  CHECK(fb("BAD,Incorrect result\n") == Feedback::Bad);
+  CHECK(fb("BAD,No job\n") == Feedback::Bad);
+  CHECK(fb("BAD\n") == Feedback::Bad);
+  CHECK(fb("BLOCK\n") == Feedback::Block);
+  CHECK(fb(" \tGOOD \r\n") == Feedback::Good);
+  CHECK(fb("") == Feedback::Unknown);
+  CHECK(fb("\r\n") == Feedback::Unknown);
+  CHECK(fb("GOO") == Feedback::Unknown);
+  CHECK(fb("BLOC") == Feedback::Unknown);
+  CHECK(fb("xGOOD") == Feedback::Unknown);
+  CHECK(fb("4.3\n") == Feedback::Unknown);  // server banner
+  CHECK(fb("\xff\xfe\x01garbage") == Feedback::Unknown);
+  CHECK(duco_protocol::parseFeedback(nullptr, 0) == Feedback::Unknown);
+  // Only the first len bytes count.
+  CHECK(duco_protocol::parseFeedback("GOOD", 3) == Feedback::Unknown);
+}
+
+void testBuildJobRequest_() {
+  static const char kWant[] = "JOB,alice,LOW,k3y\n";
+  const size_t wantLen = sizeof(kWant) - 1;
+  char out[64];
+  memset(out, '#', sizeof(out));
+  CHECK(duco_protocol::buildJobRequest(out, sizeof(out), "alice", "k3y") == wantLen);
+  CHECK(memcmp(out, kWant, wantLen + 1) == 0);  // incl. NUL
+  // Exactly enough room for the text + NUL; one less does not fit.
+  CHECK(duco_protocol::buildJobRequest(out, wantLen + 1, "alice", "k3y") == wantLen);
+  CHECK(memcmp(out, kWant, wantLen + 1) == 0);
+  CHECK(duco_protocol::buildJobRequest(out, wantLen, "alice", "k3y") == 0);
+  CHECK(duco_protocol::buildJobRequest(out, 4, "alice", "k3y") == 0);
+  // Missing user / key become empty fields.
+  CHECK(duco_protocol::buildJobRequest(out, sizeof(out), nullptr, nullptr) == 10);
+  CHECK(strcmp(out, "JOB,,LOW,\n") == 0);
+}
+
+void testBuildSubmit_() {
+  static const char kWant[] =
+      "149181,41234.57,Official ESP32 Miner 4.3,Stackchan,DUCOID1A2B3C4D5E6F,2811\n";
+  const size_t wantLen = sizeof(kWant) - 1;
+  char out[duco_protocol::kMaxLine];
+  const size_t n = duco_protocol::buildSubmit(out, sizeof(out), 149181, 41234.567f,
+                                              "Official ESP32 Miner", "4.3", "Stackchan",
+                                              "1A2B3C4D5E6F", 2811);
+  CHECK(n == wantLen);
+  CHECK(memcmp(out, kWant, wantLen + 1) == 0);
+  CHECK(duco_protocol::buildSubmit(out, wantLen + 1, 149181, 41234.567f,
+                                   "Official ESP32 Miner", "4.3", "Stackchan",
+                                   "1A2B3C4D5E6F", 2811) == wantLen);
+  CHECK(duco_protocol::buildSubmit(out, wantLen, 149181, 41234.567f,
+                                   "Official ESP32 Miner", "4.3", "Stackchan",
+                                   "1A2B3C4D5E6F", 2811) == 0);
+  // Largest nonce, zero hashrate, missing strings.
+  CHECK(duco_protocol::buildSubmit(out, sizeof(out), 4294967295u, 0.0f,
+                                   nullptr, nullptr, nullptr, nullptr, 0) == 28);
+  CHECK(strcmp(out, "4294967295,0.00, ,,DUCOID,0\n") == 0);
+}
+
+void testTrimCopy_() {
+  char out[8];
+  CHECK(duco_protocol::trimCopy(out, sizeof(out), " GOOD\r\n", 7) == 4);
+  CHECK(strcmp(out, "GOOD") == 0);
+  CHECK(duco_protocol::trimCopy(out, sizeof(out), "BAD,Incorrect result\n", 21) == 7);
+  CHECK(strcmp(out, "BAD,Inc") == 0);
+  CHECK(duco_protocol::trimCopy(out, sizeof(out), nullptr, 5) == 0);
+  CHECK(out[0] == '\0');
+}
+} // namespace
+
+int main() {
+  testParseJobPoolLines_();
+  testParseJobTruncated_();
+  testParseJobDifficulty_();
+  testParseJobOverlong_();
+  testMalformedNotSolved_();
+  testParseFeedback_();
+  testBuildJobRequest_();
+  testBuildSubmit_();
+  testTrimCopy_();
+  if (g_failures) {
+    fprintf(stderr, "duco_protocol: %d check(s) failed\n", g_failures);
+    return 1;
+  }
+  printf("duco_protocol: all checks passed\n");
+  return 0;
+}
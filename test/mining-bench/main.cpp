@@ -0,0 +1,158 @@
+// Mining solver benchmark (host).
+//
+// Runs every built solver backend over DUCO jobs and prints H/s, so kernels
+// can be compared on a PC before flashing.
+//
+//   pio run -e native && .pio/build/native/program [jobs.txt]
+//
+// jobs.txt (optional): one pool job line per row, "prev,expected,diff"
+// (the same text the pool sends after JOB). Without it the built-in jobs
+// below are used; their solving nonce is known, so results are also checked.
+// Before timing, every hashLanes<N> is checked digest-for-digest against the
+// scalar hash() across digit-count boundaries.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "ai/duco_sha1.h"
+#include "ai/mining_solver.h"
+
+namespace {
+struct BenchJob {
+  std::string prev;
+  std::string expected;
+  uint32_t diff = 0;
+  uint32_t nonce = UINT32_MAX;  // known answer (UINT32_MAX = unknown)
+};
+
+// prev,expected,diff,nonce (nonce precomputed with hashlib.sha1)
+const BenchJob kBuiltinJobs[] = {
+  {"a4c123b1612dd272d1371c17149d439536b3216f", "995ed64f70f98777cf5d3672a971a0d941c7b591", 1500, 149181},
+  {"daeeb975729fae923d5a4fd12aabfe228f219e9c", "7b85712fe71ca705b7165a8fa72928dea67b5ff2", 3000, 295283},
+  {"b0eb53f16947ccf25ec84d8dbc74254770f58904", "685e75d8ff2660174eb1ad98dd345260da62c0c8", 6000, 459648},
+  {"ba41ecccc3fc1626e53a13043b026c48bbf33fef", "b05744d3603c9d54de06afaf891a53a395d15d1f", 6000, 493668},
+};
+
+bool parseJobLine_(const char* line, BenchJob& out) {
+  const char* c1 = strchr(line, ',');
+  if (!c1) return false;
+  const char* c2 = strchr(c1 + 1, ',');
+  if (!c2) return false;
+  out.prev.assign(line, c1 - line);
+  out.expected.assign(c1 + 1, c2 - c1 - 1);
+  out.diff = (uint32_t)strtoul(c2 + 1, nullptr, 10);
+  out.nonce = UINT32_MAX;
+  return out.diff > 0;
+}
+
+// hashLanes<N> vs hash() from `from`, count nonces per lane, cursors
+// stepping by N as in the solver. Returns the number of mismatches.
+template <int N>
+int checkLanes_(const duco_sha1::Midstate& mid, uint32_t from, uint32_t count) {
+  duco_sha1::NonceCursor lanes[N];
+  for (int l = 0; l < N; ++l) lanes[l].reset(mid, from + (uint32_t)l);
+  duco_sha1::NonceCursor ref;
+  uint32_t h[N][5];
+  uint32_t r[5];
+  int bad = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    duco_sha1::hashLanes<N>(mid, lanes, h);
+    for (int l = 0; l < N; ++l) {
+      ref.reset(mid, lanes[l].value());
+      duco_sha1::hash(mid, ref, r);
+      if (memcmp(h[l], r, sizeof(r)) != 0) ++bad;
+      lanes[l].next((uint8_t)N);
+    }
+  }
+  return bad;
+}
+
+int checkKernels_(const BenchJob& j) {
+  duco_sha1::Midstate mid;
+  if (!duco_sha1::prepare(mid, j.prev.c_str(), j.prev.size())) return 0;
+  // Starts just below 10^k so the cursors grow a digit mid-run.
+  static const uint32_t kFrom[] = {0, 95, 99990, 999999990u, 4294967000u};
+  int bad = 0;
+  for (uint32_t from : kFrom) {
+    bad += checkLanes_<3>(mid, from, 64);
+    bad += checkLanes_<4>(mid, from, 64);
+  }
+  return bad;
+}
+
+std::vector<BenchJob> loadJobs_(const char* path) {
+  std::vector<BenchJob> jobs;
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return jobs;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    BenchJob j;
+    if (parseJobLine_(line, j)) jobs.push_back(j);
+  }
+  fclose(f);
+  return jobs;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  std::vector<BenchJob> jobs;
+  if (argc > 1) {
+    jobs = loadJobs_(argv[1]);
+  } else {
+    jobs.assign(kBuiltinJobs, kBuiltinJobs + sizeof(kBuiltinJobs) / sizeof(kBuiltinJobs[0]));
+  }
+  if (jobs.empty()) {
+    fprintf(stderr, "no jobs\n");
+    return 1;
+  }
+  int failures = 0;
+  for (const BenchJob& j : jobs) {
+    const int bad = checkKernels_(j);
+    if (bad) {
+      fprintf(stderr, "hashLanes: %d digest mismatches on job %s\n", bad, j.prev.c_str());
+      ++failures;
+    }
+  }
+  printf("%-12s %8s %12s %10s %12s\n", "solver", "jobs", "hashes", "sec", "H/s");
+  for (uint8_t k = 0; k < mining_solver::kSolverKindCount; ++k) {
+    const auto kind = (mining_solver::SolverKind)k;
+    mining_solver::MiningSolver* solver = mining_solver::solverFor(kind);
+    if (!solver) {
+      printf("%-12s (not built)\n", mining_solver::solverName(kind));
+      continue;
+    }
+    uint64_t hashes = 0;
+    double sec = 0.0;
+    for (const BenchJob& j : jobs) {
+      mining_solver::SolveJob sj;
+      sj.seed_ = j.prev.c_str();
+      sj.seedLen_ = j.prev.size();
+      duco_sha1::decodeTarget(j.expected.c_str(), j.expected.size(), sj.target_);
+      sj.nonceBegin_ = 0;
+      sj.nonceEnd_ = j.diff * 100U;
+      const auto t0 = std::chrono::steady_clock::now();
+      const mining_solver::SolveResult r = solver->solve(sj, nullptr);
+      const auto t1 = std::chrono::steady_clock::now();
+      sec += std::chrono::duration<double>(t1 - t0).count();
+      hashes += r.hashes_;
+      const bool found = (r.status_ == mining_solver::SolveStatus::Found);
+      if (j.nonce != UINT32_MAX && (!found || r.nonce_ != j.nonce)) {
+        fprintf(stderr, "%s: job %s expected nonce %u, got %s %u\n",
+                solver->name(), j.prev.c_str(), (unsigned)j.nonce,
+                found ? "nonce" : "none", (unsigned)r.nonce_);
+        ++failures;
+      }
+    }
+    printf("%-12s %8u %12llu %10.3f %12.0f\n",
+           solver->name(), (unsigned)jobs.size(),
+           (unsigned long long)hashes, sec, sec > 0 ? hashes / sec : 0.0);
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+// NonceCursor check (host).
+//
+//   pio run -e native-cursor && .pio/build/native-cursor/program
+//
+// Walks NonceCursor::next(step) for steps 1..4 (the lane strides) over
+// 0..kDiff*100 (the nonce range of a job of difficulty kDiff) and across
+// every power of ten up to UINT32_MAX, and compares the in-place digits and
+// length() with u32ToDec(), and hash(cursor) with hash() of the rendered text.
+// Exit code 1 on any mismatch.
+#include <stdio.h>
+#include <string.h>
+
+#include "ai/duco_sha1.h"
+
+namespace {
+// Difficulty whose nonce range is walked in full (the pool's difficulty for
+// LOW boards stays well below this).
+constexpr uint32_t kDiff = 100000;
+// 40-char seed as the pool sends it.
+const char* kSeed = "a4c123b1612dd272d1371c17149d439536b3216f";
+// Cursor strides to check: 1 up to the widest hashLanes<N>.
+const uint8_t kSteps[] = {1, 2, 3, 4};
+
+// Cursor digits vs the division-based render; on mismatch prints the first.
+bool sameDigits_(const duco_sha1::NonceCursor& cur) {
+  char want[duco_sha1::kMaxNonceDigits];
+  char got[duco_sha1::kMaxNonceDigits];
+  const int wn = duco_sha1::u32ToDec(want, cur.value());
+  const int gn = cur.copyDigits(got);
+  if (wn == gn && cur.length() == gn && memcmp(want, got, (size_t)wn) == 0) return true;
+  fprintf(stderr, "NonceCursor: value %u renders \"%.*s\", cursor has \"%.*s\"\n",
+          (unsigned)cur.value(), wn, want, gn, got);
+  return false;
+}
+// hash(cursor) vs hash() of the rendered text (catches pad / W15 errors).
+bool sameDigest_(const duco_sha1::Midstate& mid, const duco_sha1::NonceCursor& cur) {
+  char text[duco_sha1::kMaxNonceDigits];
+  const int n = duco_sha1::u32ToDec(text, cur.value());
+  uint32_t a[5], b[5];
+  duco_sha1::hash(mid, cur, a);
+  duco_sha1::hash(mid, text, (size_t)n, b);
+  if (memcmp(a, b, sizeof(a)) == 0) return true;
+  fprintf(stderr, "NonceCursor: digest mismatch at %u\n", (unsigned)cur.value());
+  return false;
+}
+
+// Every nonce in 0..last for each lane of a step-`step` walk, as the solver
+// steps its cursors. Digests are sampled (every 4096th) to keep it quick.
+int checkRange_(const duco_sha1::Midstate& mid, uint8_t step, uint32_t last) {
+  int bad = 0;
+  for (uint8_t lane = 0; lane < step; ++lane) {
+    duco_sha1::NonceCursor cur;
+    cur.reset(mid, lane);
+    for (;;) {
+      if (!sameDigits_(cur) || ((cur.value() & 4095u) < step && !sameDigest_(mid, cur))) {
+        if (++bad > 8) return bad;
+      }
+      if (cur.value() > last - step) break;
+      cur.next(step);
+    }
+  }
+  return bad;
+}
+
+// Walks across 9->10, 99->100, ..., 999999999->1000000000 (and up to
+// UINT32_MAX) from every start offset, checking digits and digest each step.
+int checkBoundaries_(const duco_sha1::Midstate& mid, uint8_t step) {
+  int bad = 0;
+  uint64_t p = 10;
+  for (int k = 1; k <= 10; ++k, p *= 10) {
+    const uint64_t edge = (p > UINT32_MAX) ? (uint64_t)UINT32_MAX - 40 : p;
+    const uint64_t from = (edge > 3u * step + 10u) ? edge - 3u * step - 10u : 0;
+    for (uint64_t s = from; s < edge; ++s) {
+      duco_sha1::NonceCursor cur;
+      cur.reset(mid, (uint32_t)s);
+      while ((uint64_t)cur.value() + step <= edge + 3u * step &&
+             (uint64_t)cur.value() + step <= UINT32_MAX) {
+        cur.next(step);
+        if (!sameDigits_(cur) || !sameDigest_(mid, cur)) {
+          if (++bad > 8) return bad;
+        }
+      }
+    }
+  }
+  return bad;
+}
+} // namespace
+
+int main() {
+  duco_sha1::Midstate mid;
+  if (!duco_sha1::prepare(mid, kSeed, strlen(kSeed))) {
+    fprintf(stderr, "prepare() rejected a 40-char seed\n");
+    return 1;
+  }
+  int bad = 0;
+  for (uint8_t step : kSteps) {
+    bad += checkRange_(mid, step, kDiff * 100U);
+    bad += checkBoundaries_(mid, step);
+  }
+  if (bad) {
+    fprintf(stderr, "NonceCursor: %d mismatches against u32ToDec\n", bad);
+    return 1;
+  }
+  printf("NonceCursor: 0..%u and every power of ten match u32ToDec\n",
+         (unsigned)(kDiff * 100U));
+  return 0;
+}
@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""Local DUCO pool stand-in for miner integration / throughput tests.
+
+Serves:
+  - HTTP  GET /getPool  -> {"name", "ip", "port", "success"}  (pool discovery)
+  - TCP   pool protocol -> banner, JOB -> "prev,expected,diff", submit -> GOOD/BAD
+
+Point the firmware at it with a build flag (see docs/pool_emulator.md):
+  -DMC_DUCO_POOL_URL=\\"http://<pc-ip>:8080/getPool\\"
+
+Faults are configurable (latency, connection drops, forced BAD, reissuing the
+job of a dropped connection) so reconnect behaviour, resume and shares/min can
+be measured reproducibly (--seed).
+"""
+import argparse
+import asyncio
+import hashlib
+import json
+import random
+import time
+
+
+class Stats:
+    def __init__(self):
+        self.t0 = time.monotonic()
+        self.jobs = 0
+        self.good = 0
+        self.bad = 0
+        self.forced_bad = 0
+        self.drops = 0
+        self.reissued = 0
+        self.conns = 0
+        self.active = 0
+
+    def line(self):
+        mins = max(time.monotonic() - self.t0, 1e-6) / 60.0
+        return ("conns=%d active=%d jobs=%d good=%d bad=%d (forced %d) drops=%d "
+                "reissued=%d shares/min=%.2f"
+                % (self.conns, self.active, self.jobs, self.good, self.bad,
+                   self.forced_bad, self.drops, self.reissued,
+                   (self.good + self.bad) / mins))
+
+
+def make_job(rng, diff):
+    prev = "%040x" % rng.getrandbits(160)
+    nonce = rng.randint(0, diff * 100)
+    expected = hashlib.sha1((prev + str(nonce)).encode()).hexdigest()
+    return prev, expected, nonce
+
+
+async def delay(args, rng):
+    ms = args.latency_ms + (rng.uniform(0, args.jitter_ms) if args.jitter_ms else 0)
+    if ms > 0:
+        await asyncio.sleep(ms / 1000.0)
+
+
+async def handle_pool(reader, writer, args, rng, stats, orphans):
+    peer = writer.get_extra_info("peername")
+    stats.conns += 1
+    stats.active += 1
+    job = None
+    try:
+        writer.write(("%s\n" % args.banner).encode())
+        await writer.drain()
+        while True:
+            raw = await reader.readline()
+            if not raw:
+                break
+            line = raw.decode(errors="replace").strip()
+            if not line:
+                continue
+            if rng.random() < args.drop_rate:
+                stats.drops += 1
+                print("[%s] drop after %r" % (peer, line[:24]))
+                break
+            await delay(args, rng)
+            if line.startswith("JOB,"):
+                diff = args.difficulty
+                if orphans and rng.random() < args.reissue_rate:
+                    # Job of a dropped connection again: the miner should
+                    # log "resume hit" and finish it quickly.
+                    job = orphans.pop(0)
+                    stats.reissued += 1
+                else:
+                    job = make_job(rng, diff)
+                stats.jobs += 1
+                writer.write(("%s,%s,%d\n" % (job[0], job[1], diff)).encode())
+            elif job is not None:
+                fields = line.split(",")
+                try:
+                    nonce = int(fields[0])
+                except ValueError:
+                    nonce = -1
+                ok = hashlib.sha1((job[0] + str(nonce)).encode()).hexdigest() == job[1]
+                if ok and rng.random() < args.bad_rate:
+                    ok = False
+                    stats.forced_bad += 1
+                if ok:
+                    stats.good += 1
+                    writer.write(b"GOOD\n")
+                else:
+                    stats.bad += 1
+                    writer.write(b"BAD,Incorrect result\n")
+                if args.verbose:
+                    print("[%s] submit %s -> %s" % (peer, line, "GOOD" if ok else "BAD"))
+                job = None
+            else:
+                writer.write(b"BAD,No job\n")
+            await writer.drain()
+    except (ConnectionError, asyncio.IncompleteReadError):
+        pass
+    finally:
+        if job is not None and args.reissue_rate > 0:
+            orphans.append(job)
+            del orphans[:-8]
+        stats.active -= 1
+        writer.close()
+
+
+async def handle_http(reader, writer, args):
+    try:
+        request = await reader.readline()
+        while True:
+            h = await reader.readline()
+            if not h or h in (b"\r\n", b"\n"):
+                break
+        parts = request.decode(errors="replace").split()
+        path = parts[1] if len(parts) > 1 else "/"
+        if path.startswith("/getPool"):
+            body = json.dumps({"name": args.name, "ip": args.advertise_ip,
+                               "port": args.pool_port, "success": True}).encode()
+            status = b"200 OK"
+        else:
+            body = b"not found"
+            status = b"404 Not Found"
+        writer.write(b"HTTP/1.1 " + status + b"\r\nContent-Type: application/json\r\n"
+                     b"Content-Length: " + str(len(body)).encode() +
+                     b"\r\nConnection: close\r\n\r\n" + body)
+        await writer.drain()
+    finally:
+        writer.close()
+
+
+async def report(stats, interval):
+    while True:
+        await asyncio.sleep(interval)
+        print(stats.line(), flush=True)
+
+
+async def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--bind", default="0.0.0.0")
+    ap.add_argument("--advertise-ip", default="127.0.0.1",
+                    help="IP returned by getPool (the PC's LAN address for a device)")
+    ap.add_argument("--http-port", type=int, default=8080)
+    ap.add_argument("--pool-port", type=int, default=2811)
+    ap.add_argument("--name", default="local-emu")
+    ap.add_argument("--banner", default="3.0")
+    ap.add_argument("--difficulty", type=int, default=1500)
+    ap.add_argument("--latency-ms", type=float, default=0.0)
+    ap.add_argument("--jitter-ms", type=float, default=0.0)
+    ap.add_argument("--drop-rate", type=float, default=0.0,
+                    help="probability to close the connection on a request")
+    ap.add_argument("--bad-rate", type=float, default=0.0,
+                    help="probability to answer BAD to a correct share")
+    ap.add_argument("--reissue-rate", type=float, default=0.0,
+                    help="probability to answer JOB with the unsolved job of a "
+                         "dropped connection (exercises the miner's resume slots)")
+    ap.add_argument("--stats-interval", type=float, default=10.0)
+    ap.add_argument("--seed", type=int, default=None)
+    ap.add_argument("-v", "--verbose", action="store_true")
+    args = ap.parse_args()
+
+    rng = random.Random(args.seed)
+    stats = Stats()
+    orphans = []  # unsolved jobs of dropped connections, oldest first
+    pool = await asyncio.start_server(
+        lambda r, w: handle_pool(r, w, args, rng, stats, orphans),
+        args.bind, args.pool_port)
+    http = await asyncio.start_server(
+        lambda r, w: handle_http(r, w, args), args.bind, args.http_port)
+    print("getPool: http://%s:%d/getPool -> %s:%d (diff %d)"
+          % (args.advertise_ip, args.http_port, args.advertise_ip, args.pool_port,
+             args.difficulty), flush=True)
+    asyncio.ensure_future(report(stats, args.stats_interval))
+    async with pool, http:
+        await asyncio.gather(pool.serve_forever(), http.serve_forever())
+
+
+if __name__ == "__main__":
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        pass